@@ -0,0 +1,221 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef ADAPTIVE_SWEEP_H
+#define ADAPTIVE_SWEEP_H
+
+// Refinamento adaptativo de nWifi em torno do joelho de saturação.
+//
+// A grade grossa (--nWifi) roda primeiro. Cada combinação dos outros eixos
+// é uma curva métrica x nWifi; para cada intervalo entre dois nWifi
+// vizinhos ainda divisível a nota é
+//   (|y2 - y1| + |variação de inclinação| * largura + erro1 + erro2) / amplitude
+// ou seja, onde a curva mais muda, mais dobra ou é mais ruidosa. O ponto
+// médio dos intervalos de maior nota é simulado, as notas são recalculadas
+// e assim até o orçamento de rodadas (--adaptBudget, contando a grade
+// grossa) acabar. As decisões dependem só dos resultados, então --resume
+// refaz a mesma sequência de pontos a partir do journal.
+
+#include "sweep.h"
+#include "sweepRunner.h"
+#include "runResult.h"
+#include <vector>
+#include <map>
+#include <string>
+#include <ostream>
+#include <algorithm>
+#include <cmath>
+
+namespace ns3 {
+
+class AmostradorAdaptativo
+{
+public:
+	AmostradorAdaptativo (MetricaAlvo metrica)
+		: m_metrica (metrica)
+	{
+	}
+
+	void Adicionar (const PontoGrade &g, const std::vector<double> &valores)
+	{
+		Amostra a;
+		a.ponto = g;
+		a.media = 0.0;
+		a.erro = 0.0;
+		for (uint32_t i = 0; i < valores.size (); i++) {
+			a.media += valores[i];
+		}
+		if (!valores.empty ()) {
+			a.media /= valores.size ();
+		}
+		if (valores.size () > 1) {
+			double soma = 0.0;
+			for (uint32_t i = 0; i < valores.size (); i++) {
+				soma += (valores[i] - a.media) * (valores[i] - a.media);
+			}
+			a.erro = std::sqrt (soma / (valores.size () - 1)) / std::sqrt ((double) valores.size ());
+		}
+
+		std::string chave = Curva (g);
+		std::map<std::string, uint32_t>::const_iterator c = m_indice.find (chave);
+		if (c == m_indice.end ()) {
+			m_indice[chave] = m_curvas.size ();
+			m_curvas.push_back (std::vector<Amostra> ());
+			m_curvas.back ().push_back (a);
+		} else {
+			std::vector<Amostra> &curva = m_curvas[c->second];
+			uint32_t pos = 0;
+			while (pos < curva.size () && curva[pos].ponto.nWifi < g.nWifi) {
+				pos++;
+			}
+			curva.insert (curva.begin () + pos, a);
+		}
+	}
+
+	// Até max pontos novos, no máximo um por intervalo.
+	std::vector<PontoGrade> Proximos (uint32_t max) const
+	{
+		std::vector<std::pair<double, PontoGrade> > candidatos;
+		for (uint32_t c = 0; c < m_curvas.size (); c++) {
+			const std::vector<Amostra> &v = m_curvas[c];
+			if (v.size () < 2) {
+				continue;
+			}
+			double menor = v[0].media, maior = v[0].media;
+			std::vector<double> inclinacao;
+			for (uint32_t i = 0; i < v.size (); i++) {
+				menor = std::min (menor, v[i].media);
+				maior = std::max (maior, v[i].media);
+				if (i + 1 < v.size ()) {
+					inclinacao.push_back ((v[i + 1].media - v[i].media) / (v[i + 1].ponto.nWifi - v[i].ponto.nWifi));
+				}
+			}
+			double amplitude = maior - menor > 0.0 ? maior - menor : 1.0;
+			for (uint32_t i = 0; i + 1 < v.size (); i++) {
+				uint32_t largura = v[i + 1].ponto.nWifi - v[i].ponto.nWifi;
+				if (largura < 2) {
+					continue;
+				}
+				double curvatura = 0.0;
+				if (i > 0) {
+					curvatura = std::max (curvatura, std::fabs (inclinacao[i] - inclinacao[i - 1]));
+				}
+				if (i + 1 < inclinacao.size ()) {
+					curvatura = std::max (curvatura, std::fabs (inclinacao[i + 1] - inclinacao[i]));
+				}
+				double nota = (std::fabs (v[i + 1].media - v[i].media) + curvatura * largura + v[i].erro + v[i + 1].erro) / amplitude;
+				PontoGrade novo = v[i].ponto;
+				novo.nWifi = v[i].ponto.nWifi + largura / 2;
+				candidatos.push_back (std::make_pair (nota, novo));
+			}
+		}
+		std::stable_sort (candidatos.begin (), candidatos.end (), MaiorNota);
+		std::vector<PontoGrade> proximos;
+		for (uint32_t i = 0; i < candidatos.size () && i < max; i++) {
+			proximos.push_back (candidatos[i].second);
+		}
+		return proximos;
+	}
+
+	void Imprimir (std::ostream &os) const
+	{
+		const char *nomes[] = { "vazao (kbps)", "perda", "atraso (s)" };
+		os << "\n\nCurva adaptativa: " << nomes[m_metrica] << "\n";
+		os << "ponto;";
+		os << "média;";
+		os << "erro padrão;";
+		os << "\n";
+		for (uint32_t c = 0; c < m_curvas.size (); c++) {
+			for (uint32_t i = 0; i < m_curvas[c].size (); i++) {
+				os << m_curvas[c][i].ponto.Rotulo () << ";";
+				os << m_curvas[c][i].media << ";";
+				os << m_curvas[c][i].erro << ";";
+				os << "\n";
+			}
+		}
+	}
+
+private:
+	struct Amostra {
+		PontoGrade ponto;
+		double media;
+		double erro;   // erro padrão da média entre repetições
+	};
+
+	static std::string Curva (const PontoGrade &g)
+	{
+		std::ostringstream oss;
+		oss << g.packetSize << "|" << g.dataRate << "|" << g.p2pRate;
+		return oss.str ();
+	}
+
+	static bool MaiorNota (const std::pair<double, PontoGrade> &a, const std::pair<double, PontoGrade> &b)
+	{
+		return a.first > b.first;
+	}
+
+	MetricaAlvo m_metrica;
+	std::map<std::string, uint32_t> m_indice;
+	std::vector<std::vector<Amostra> > m_curvas;
+};
+
+// Roda depois da grade grossa já executada pelo runner; acrescenta pontos
+// até o orçamento e imprime a curva resultante.
+inline bool
+RefinarVarredura (SweepRunner &runner, uint32_t repeticao, SweepRunner::Descrever descrever, SweepRunner::Simular simular,
+                  const OpcoesVarredura &o, std::ostream &os)
+{
+	MetricaAlvo metrica;
+	if (!MetricaDeNome (o.adaptMetric, metrica)) {
+		return false;
+	}
+	AmostradorAdaptativo amostrador (metrica);
+	uint32_t vistos = 0;
+	uint32_t usadas = runner.GetGrade ().size () * repeticao;
+	// Um ponto por rodada de refinamento já ocupa repeticao processos; mais
+	// pontos só se os jobs sobrarem.
+	uint32_t lote = std::max (1u, (o.jobs + repeticao - 1) / repeticao);
+
+	while (true) {
+		const std::vector<PontoGrade> &grade = runner.GetGrade ();
+		for (; vistos < grade.size (); vistos++) {
+			std::vector<double> valores;
+			for (uint32_t k = 1; k <= repeticao; k++) {
+				valores.push_back (MetricaRodada (runner.Resultado (vistos, k), metrica));
+			}
+			amostrador.Adicionar (grade[vistos], valores);
+		}
+		if (usadas + repeticao > o.adaptBudget) {
+			break;
+		}
+		uint32_t cabem = (o.adaptBudget - usadas) / repeticao;
+		std::vector<PontoGrade> novos = amostrador.Proximos (std::min (lote, cabem));
+		if (novos.empty ()) {
+			break;
+		}
+		if (!runner.Executar (novos, repeticao, descrever, simular)) {
+			return false;
+		}
+		usadas += novos.size () * repeticao;
+	}
+
+	amostrador.Imprimir (os);
+	return true;
+}
+
+} // namespace ns3
+
+#endif /* ADAPTIVE_SWEEP_H */
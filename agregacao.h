@@ -0,0 +1,296 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef AGREGACAO_H
+#define AGREGACAO_H
+
+// Agregação por nWifi das repetições: média e desvio padrão de cada campo
+// por fluxo e a "Média NÓS" dos cálculos importantes. Imprime exatamente a
+// tabela do fim do laço z dos programas *2.cc (cálculo em double, como nos
+// rajada*2.cc), seguida das colunas de intervalo de confiança: IC t de 95%
+// dos cálculos importantes e IC bootstrap dos bitrates e da perda.
+// Fluxos cuja métrica não é definida (nada recebido, por exemplo) ficam com
+// NaN na própria linha e fora da "Média NÓS", que informa quantos fluxos
+// entraram em cada média e quantos ficaram sem recepção em cada repetição.
+
+#include "flowRecord.h"
+#include "runResult.h"
+#include "metricKernels.h"
+#include "estatistica.h"
+#include <vector>
+#include <string>
+#include <ostream>
+#include <cmath>
+#include <limits>
+#include <cassert>
+#include <stdint.h>
+
+class Agregador
+{
+public:
+	Agregador (uint32_t numNos, uint32_t repeticao, const OpcoesEstatistica &estatistica = OpcoesEstatistica ())
+		: m_numNos (numNos),
+		  m_repeticao (repeticao),
+		  m_estatistica (estatistica),
+		  m_source (numNos, 0),
+		  m_destination (numNos, 0),
+		  m_tabela (numNos, repeticao),
+		  m_acumulado (false)
+	{
+	}
+
+	// slot: posição do fluxo na tabela (0..numNos-1); k: repetição (1..repeticao)
+	void Adicionar (uint32_t slot, uint32_t k, const FlowRecord &r)
+	{
+		if (slot >= m_numNos || k < 1 || k > m_repeticao) {
+			return;
+		}
+		m_acumulado = false;
+		if (k == 1) {
+			m_source[slot] = r.sourceAddress;
+			m_destination[slot] = r.destinationAddress;
+		}
+		double v[TabelaMetricas::NUM_CAMPOS] = {
+			r.timeFirstTxPacket, r.timeFirstRxPacket, r.timeLastTxPacket, r.timeLastRxPacket,
+			r.delaySum, r.jitterSum, r.lastDelay,
+			(1.0) * r.txBytes, (1.0) * r.rxBytes, (1.0) * r.txPackets, (1.0) * r.rxPackets, (1.0) * r.lostPackets
+		};
+		/*Guarda o valor de cada nó; médias e desvios saem numa passada só no Imprimir*/
+		for (uint32_t c = 0; c < TabelaMetricas::NUM_CAMPOS; c++) {
+			m_tabela.Valores (c, k - 1)[slot] = v[c];
+		}
+	}
+
+	// Médias e desvios de tudo o que foi adicionado; antes do Imprimir
+	void Acumular (void)
+	{
+		m_tabela.Acumular ();
+		m_acumulado = true;
+	}
+
+	void Imprimir (std::ostream &os, uint32_t nWifi) const
+	{
+		assert (m_acumulado);
+		uint32_t repeticao = m_repeticao;
+
+		os << "\n\n";
+		os << "Número de nós do wifi: " << nWifi << " \n";
+		os << "Quantidade de repetições: " << repeticao << " \n";
+
+		os << "Flow;";
+		os << "Source;";
+		os << "Destination;";
+		for (uint32_t c = 0; c < TabelaMetricas::NUM_CAMPOS; c++) {
+			os << NomeCampo (c) << ";";
+			os << "dp;";
+		}
+		CabecalhoImportantes (os);
+		CabecalhoIntervalos (os);
+		os << "IC95 boot MeanTransmittedBitrate inf;";
+		os << "sup;";
+		os << "IC95 boot MeanReceivedBitrate inf;";
+		os << "sup;";
+		os << "IC95 boot MeanPacketLossRatio inf;";
+		os << "sup;";
+		os << "\n";
+
+		std::vector<double> inf, sup;
+		Bootstrap (inf, sup);
+
+		std::vector<double> soma (TabelaMetricas::NUM_DERIVADAS, 0.0);
+		std::vector<double> porNo (TabelaMetricas::NUM_DERIVADAS * m_numNos, 0.0);
+		std::vector<uint32_t> validos (TabelaMetricas::NUM_DERIVADAS, 0);
+		std::vector<double> ic (TabelaMetricas::NUM_DERIVADAS);
+
+		for (uint32_t j = 0; j < m_numNos; j++) {
+			os << j+1;//Flow
+			os << ";";
+			os << EnderecoStr (m_source[j]);
+			os << ";";
+			os << EnderecoStr (m_destination[j]);
+			os << ";";
+
+			for (uint32_t c = 0; c < TabelaMetricas::NUM_CAMPOS; c++) {
+				double media = m_tabela.Media (c, j);
+				os << media << ";" << m_tabela.DesvioPadrao (c, j, media) << ";";
+			}
+
+			/*Média é a razão das médias; desvio das razões de cada repetição em torno dela*/
+			for (uint32_t m = 0; m < TabelaMetricas::NUM_DERIVADAS; m++) {
+				uint32_t s = TabelaMetricas::NUM_CAMPOS + m;
+				double media = m_tabela.MediaDerivada (s, j);
+				if (m_tabela.MediaValida (s, j)) {
+					soma[m] += media;
+					porNo[m * m_numNos + validos[m]++] = media;
+				}
+				double dp = m_tabela.DesvioPadrao (s, j, media);
+				ic[m] = MeiaLarguraT (dp, m_tabela.Validas (s, j));
+				os << media << ";" << dp << ";";
+			}
+			for (uint32_t m = 0; m < TabelaMetricas::NUM_DERIVADAS; m++) {
+				os << ic[m] << ";";
+			}
+			for (uint32_t q = 0; q < NUM_RAZOES; q++) {
+				os << inf[q * m_numNos + j] << ";" << sup[q * m_numNos + j] << ";";
+			}
+
+			os << "\n";
+		}
+
+		os << "\n";
+		os << "Média NÓS\n";
+
+		CabecalhoImportantes (os);
+		CabecalhoIntervalos (os);
+		os << "\n";
+
+		for (uint32_t m = 0; m < TabelaMetricas::NUM_DERIVADAS; m++) {
+			double media = soma[m]/(validos[m]);
+			double dp = CalcDesvioPadrao (validos[m], &porNo[m * m_numNos], media);
+			ic[m] = MeiaLarguraT (dp, validos[m]);
+			os << media << ";" << dp << ";";
+		}
+		for (uint32_t m = 0; m < TabelaMetricas::NUM_DERIVADAS; m++) {
+			os << ic[m] << ";";
+		}
+		os << "\n";
+
+		os << "Fluxos na média;";
+		for (uint32_t m = 0; m < TabelaMetricas::NUM_DERIVADAS; m++) {
+			os << validos[m] << ";";
+		}
+		os << "\n";
+		os << "Fluxos sem recepção por repetição;";
+		for (uint32_t k = 0; k < repeticao; k++) {
+			os << m_tabela.SemRecepcao (k) << ";";
+		}
+		os << "\n\n";
+	}
+
+private:
+	static const uint32_t NUM_RAZOES = 3;
+
+	// Bitrates Tx/Rx e perda como sum(num)/sum(den) por repetição, [k][fluxo]
+	void Bootstrap (std::vector<double> &inf, std::vector<double> &sup) const
+	{
+		uint32_t total = m_repeticao * m_numNos;
+		std::vector<double> txBits (total), rxBits (total), txDur (total), rxDur (total), enviados (total);
+		const double *txBytes = m_tabela.Valores (TabelaMetricas::TX_BYTES, 0);
+		const double *rxBytes = m_tabela.Valores (TabelaMetricas::RX_BYTES, 0);
+		const double *firstTx = m_tabela.Valores (TabelaMetricas::FIRST_TX, 0);
+		const double *lastTx = m_tabela.Valores (TabelaMetricas::LAST_TX, 0);
+		const double *firstRx = m_tabela.Valores (TabelaMetricas::FIRST_RX, 0);
+		const double *lastRx = m_tabela.Valores (TabelaMetricas::LAST_RX, 0);
+		const double *rxPackets = m_tabela.Valores (TabelaMetricas::RX_PACKETS, 0);
+		const double *lost = m_tabela.Valores (TabelaMetricas::LOST_PACKETS, 0);
+		for (uint32_t i = 0; i < total; i++) {
+			txBits[i] = 8 * txBytes[i];
+			rxBits[i] = 8 * rxBytes[i];
+			txDur[i] = lastTx[i] - firstTx[i];
+			rxDur[i] = lastRx[i] - firstRx[i];
+			enviados[i] = rxPackets[i] + lost[i];
+		}
+		std::vector<const double *> num, den;
+		num.push_back (&txBits[0]);
+		den.push_back (&txDur[0]);
+		num.push_back (&rxBits[0]);
+		den.push_back (&rxDur[0]);
+		num.push_back (lost);
+		den.push_back (&enviados[0]);
+		BootstrapRazoes (num, den, m_numNos, m_repeticao, m_estatistica, inf, sup);
+	}
+
+	static void CabecalhoIntervalos (std::ostream &os)
+	{
+		os << "IC95 Meandelay (+-);";
+		os << "IC95 Meanjitter (+-);";
+		os << "IC95 MeanTransmittedPacketSize (+-);";
+		os << "IC95 MeanReceivedPacketSize (+-);";
+		os << "IC95 MeanTransmittedBitrate (+-);";
+		os << "IC95 MeanReceivedBitrate (+-);";
+		os << "IC95 MeanPacketLossRatio (+-);";
+	}
+
+	static const char *NomeCampo (uint32_t c)
+	{
+		static const char *nomes[TabelaMetricas::NUM_CAMPOS] = {
+			"timeFirstTxPacket", "timeFirstRxPacket", "timeLastTxPacket", "timeLastRxPacket",
+			"delaySum", "jitterSum", "lastDelay",
+			"txBytes", "rxBytes", "txPackets", "rxPackets", "lostPackets"
+		};
+		return nomes[c];
+	}
+
+	static void CabecalhoImportantes (std::ostream &os)
+	{
+		os << "Meandelay;";
+		os << "dp;";
+		os << "Meanjitter;";
+		os << "dp;";
+		os << "MeanTransmittedPacketSize (byte);";
+		os << "dp;";
+		os << "MeanReceivedPacketSize(byte);";
+		os << "dp;";
+		os << "MeanTransmittedBitrate(bit/s);";
+		os << "dp;";
+		os << "MeanReceivedBitrate(bit/s);";
+		os << "dp;";
+		os << "MeanPacketLossRatio;";
+		os << "dp;";
+	}
+
+	static double CalcDesvioPadrao (uint32_t tamanho, const double *valorDoNo, double media)
+	{
+		double acumSum = 0.0;
+
+		if (tamanho < 2) {
+			return std::numeric_limits<double>::quiet_NaN ();
+		}
+		for(uint32_t l = 0; l < tamanho; l++) {
+			double d = valorDoNo[l] - media;
+			acumSum += d * d;
+		}
+		return sqrt (acumSum/(tamanho-1));
+	}
+
+	uint32_t m_numNos;
+	uint32_t m_repeticao;
+	OpcoesEstatistica m_estatistica;
+	std::vector<uint32_t> m_source;
+	std::vector<uint32_t> m_destination;
+	TabelaMetricas m_tabela;
+	bool m_acumulado;   // nada adicionado desde o último Acumular
+};
+
+// Distribui os fluxos de uma rodada entre as tabelas de dados e de ACK;
+// devolve true se a rodada teve algum fluxo de ACK.
+inline bool
+AgregarRodada (const ResultadoRodada &resultado, uint32_t k, Agregador &dados, Agregador &ack)
+{
+	bool temAck = false;
+	for (uint32_t i = 0; i < resultado.fluxos.size (); i++) {
+		const ResultadoFluxo &f = resultado.fluxos[i];
+		if (f.ack) {
+			ack.Adicionar (f.estacao, k, f.fluxo);
+			temAck = true;
+		} else {
+			dados.Adicionar (f.estacao, k, f.fluxo);
+		}
+	}
+	return temAck;
+}
+
+#endif /* AGREGACAO_H */
@@ -0,0 +1,312 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "agregacao.h"
+#include "estatistica.h"
+#include "metricKernels.h"
+#include "sweep.h"
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <cmath>
+#include <cstdlib>
+
+// Verificação dos cabeçalhos puros da agregação e da varredura, sem ns-3:
+//
+//   tabela     TabelaMetricas contra o cálculo antigo do Agregador (média
+//              somando na ordem das repetições, desvio em duas passadas,
+//              cálculos importantes sobre as médias), com fluxos sem
+//              recepção em algumas repetições
+//   espec      expansões de ExpandirEspec e ExpandirEspecInteiro
+//   bootstrap  BootstrapRazoes igual com 1 e com várias threads
+//   quantil    QuantilT975 contra valores tabelados da t de Student
+//
+// Imprime uma linha por verificação e sai com 1 se alguma falhar.
+//
+// Obs:
+// compila sozinho : g++ -Wall -Wextra -O2 -pthread agregacaoCheck.cc -o agregacaoCheck
+// executar comando : ./waf --run agregacaoCheck
+
+
+using namespace std;
+
+
+static uint32_t g_falhas = 0;
+
+void conferir (bool ok, const std::string &nome, const std::string &detalhe) {
+	if (!ok) {
+		g_falhas++;
+		std::cout << "FALHOU;" << nome << ";" << detalhe << "\n";
+	}
+}
+
+bool perto (double a, double b, double tolerancia) {
+	if (std::isnan (a) || std::isnan (b)) {
+		return std::isnan (a) && std::isnan (b);
+	}
+	return std::fabs (a - b) <= tolerancia * std::max (1.0, std::max (std::fabs (a), std::fabs (b)));
+}
+
+double sorteio (uint64_t &estado, double ini, double fim) {
+	return ini + (fim - ini) * (ProximoAleatorio (estado) >> 11) * (1.0 / 9007199254740992.0);
+}
+
+// Um fluxo de uma repetição; rxPackets zero quando semRecepcao
+FlowRecord fluxoAleatorio (uint64_t &estado, bool semRecepcao) {
+	FlowRecord r = FlowRecordVazio ();
+	r.timeFirstTxPacket = sorteio (estado, 1.0, 2.0);
+	r.timeLastTxPacket = r.timeFirstTxPacket + sorteio (estado, 10.0, 50.0);
+	r.txPackets = 1000 + ProximoAleatorio (estado) % 5000;
+	r.txBytes = r.txPackets * 450;
+	if (!semRecepcao) {
+		r.timeFirstRxPacket = r.timeFirstTxPacket + sorteio (estado, 0.001, 0.01);
+		r.timeLastRxPacket = r.timeLastTxPacket + sorteio (estado, 0.001, 0.01);
+		r.rxPackets = r.txPackets - ProximoAleatorio (estado) % 100;
+		r.rxBytes = r.rxPackets * 450;
+		r.delaySum = r.rxPackets * sorteio (estado, 0.001, 0.1);
+		r.jitterSum = r.rxPackets * sorteio (estado, 0.0001, 0.01);
+		r.lastDelay = sorteio (estado, 0.001, 0.1);
+	}
+	r.lostPackets = r.txPackets - r.rxPackets;
+	return r;
+}
+
+// Denominador <= 0 (nada recebido, um pacote só) é métrica indefinida; o
+// Agregador antigo imprimia inf/NaN/-0 nesses casos
+double razao (double num, double den) {
+	return den > 0.0 ? num / den : std::numeric_limits<double>::quiet_NaN ();
+}
+
+// Os sete cálculos importantes como o Agregador antigo fazia
+double importante (uint32_t m, const double *v) {
+	switch (m) {
+	case 0: return razao (v[TabelaMetricas::DELAY], v[TabelaMetricas::RX_PACKETS]);
+	case 1: return razao (v[TabelaMetricas::JITTER], v[TabelaMetricas::RX_PACKETS]-1);
+	case 2: return razao (v[TabelaMetricas::TX_BYTES], v[TabelaMetricas::TX_PACKETS]);
+	case 3: return razao (v[TabelaMetricas::RX_BYTES], v[TabelaMetricas::RX_PACKETS]);
+	case 4: return razao (8 * v[TabelaMetricas::TX_BYTES], v[TabelaMetricas::LAST_TX]-v[TabelaMetricas::FIRST_TX]);
+	case 5: return razao (8 * v[TabelaMetricas::RX_BYTES], v[TabelaMetricas::LAST_RX]-v[TabelaMetricas::FIRST_RX]);
+	default: return razao (v[TabelaMetricas::LOST_PACKETS], v[TabelaMetricas::RX_PACKETS]+v[TabelaMetricas::LOST_PACKETS]);
+	}
+}
+
+double desvioDuasPassadas (const std::vector<double> &x, double media) {
+	double acumSum = 0.0;
+	for (uint32_t l = 0; l < x.size (); l++) {
+		acumSum += (x[l] - media) * (x[l] - media);
+	}
+	return x.size () < 2 ? std::numeric_limits<double>::quiet_NaN () : std::sqrt (acumSum / (x.size () - 1));
+}
+
+void verificarTabela (void) {
+	const uint32_t numNos = 37, repeticao = 10;
+	uint64_t estado = 42;
+	TabelaMetricas tabela (numNos, repeticao);
+	Agregador agregador (numNos, repeticao);
+	// [fluxo][k][campo]
+	std::vector<double> v (numNos * repeticao * TabelaMetricas::NUM_CAMPOS);
+	for (uint32_t k = 0; k < repeticao; k++) {
+		for (uint32_t j = 0; j < numNos; j++) {
+			// fluxo 0 nunca recebe; fluxo 1 não recebe nas repetições pares
+			FlowRecord r = fluxoAleatorio (estado, j == 0 || (j == 1 && k % 2 == 0));
+			double campos[TabelaMetricas::NUM_CAMPOS] = {
+				r.timeFirstTxPacket, r.timeFirstRxPacket, r.timeLastTxPacket, r.timeLastRxPacket,
+				r.delaySum, r.jitterSum, r.lastDelay,
+				(1.0) * r.txBytes, (1.0) * r.rxBytes, (1.0) * r.txPackets, (1.0) * r.rxPackets, (1.0) * r.lostPackets
+			};
+			for (uint32_t c = 0; c < TabelaMetricas::NUM_CAMPOS; c++) {
+				tabela.Valores (c, k)[j] = campos[c];
+				v[(j * repeticao + k) * TabelaMetricas::NUM_CAMPOS + c] = campos[c];
+			}
+			agregador.Adicionar (j, k + 1, r);
+		}
+	}
+	tabela.Acumular ();
+
+	for (uint32_t j = 0; j < numNos; j++) {
+		double medias[TabelaMetricas::NUM_CAMPOS];
+		for (uint32_t c = 0; c < TabelaMetricas::NUM_CAMPOS; c++) {
+			std::vector<double> x (repeticao);
+			double soma = 0.0;
+			for (uint32_t k = 0; k < repeticao; k++) {
+				x[k] = v[(j * repeticao + k) * TabelaMetricas::NUM_CAMPOS + c];
+				soma += x[k];
+			}
+			medias[c] = soma / repeticao;
+			std::ostringstream oss;
+			oss << "fluxo " << j << " campo " << c;
+			conferir (tabela.Media (c, j) == medias[c], "tabela", oss.str () + " media");
+			conferir (perto (tabela.DesvioPadrao (c, j, medias[c]), desvioDuasPassadas (x, medias[c]), 1e-9),
+					"tabela", oss.str () + " dp");
+		}
+		for (uint32_t m = 0; m < TabelaMetricas::NUM_DERIVADAS; m++) {
+			uint32_t s = TabelaMetricas::NUM_CAMPOS + m;
+			double antiga = importante (m, medias);
+			std::ostringstream oss;
+			oss << "fluxo " << j << " derivada " << m;
+			// Denominador médio nulo: NaN e fora da "Média NÓS"
+			if (std::isfinite (antiga)) {
+				conferir (tabela.MediaDerivada (s, j) == antiga, "tabela", oss.str () + " media");
+			} else {
+				conferir (!tabela.MediaValida (s, j), "tabela", oss.str () + " invalida");
+			}
+			// Desvio das repetições em que a razão existe, em torno da razão das médias
+			std::vector<double> x;
+			for (uint32_t k = 0; k < repeticao; k++) {
+				double r = importante (m, &v[(j * repeticao + k) * TabelaMetricas::NUM_CAMPOS]);
+				if (std::isfinite (r)) {
+					x.push_back (r);
+				}
+			}
+			conferir (tabela.Validas (s, j) == x.size (), "tabela", oss.str () + " validas");
+			if (std::isfinite (antiga)) {
+				conferir (perto (tabela.DesvioPadrao (s, j, antiga), desvioDuasPassadas (x, antiga), 1e-9),
+						"tabela", oss.str () + " dp");
+			}
+		}
+	}
+	for (uint32_t k = 0; k < repeticao; k++) {
+		conferir (tabela.SemRecepcao (k) == (k % 2 == 0 ? 2u : 1u), "tabela", "fluxos sem recepcao");
+	}
+
+	// O Agregador monta a mesma tabela a partir dos FlowRecord
+	agregador.Acumular ();
+	std::ostringstream saida;
+	agregador.Imprimir (saida, numNos);
+	conferir (saida.str ().find ("Quantidade de repetições: 10") != std::string::npos, "tabela", "Imprimir");
+}
+
+void conferirEspec (const std::string &espec, const std::string &esperado) {
+	std::vector<std::string> valores;
+	std::string erro;
+	bool ok = ExpandirEspec (espec, valores, erro);
+	std::string obtido = ok ? "" : "erro";
+	for (uint32_t i = 0; ok && i < valores.size (); i++) {
+		obtido += (i > 0 ? "," : "") + valores[i];
+	}
+	conferir (obtido == esperado, "espec", "'" + espec + "' deu '" + obtido + "', esperado '" + esperado + "'");
+}
+
+void conferirEspecInteiro (const std::string &espec, const std::string &esperado) {
+	std::vector<uint32_t> valores;
+	std::string erro;
+	bool ok = ExpandirEspecInteiro (espec, valores, erro);
+	std::ostringstream oss;
+	if (!ok) {
+		oss << "erro";
+	}
+	for (uint32_t i = 0; ok && i < valores.size (); i++) {
+		oss << (i > 0 ? "," : "") << valores[i];
+	}
+	conferir (oss.str () == esperado, "espec", "inteiro '" + espec + "' deu '" + oss.str () + "', esperado '" + esperado + "'");
+}
+
+void verificarEspec (void) {
+	conferirEspec ("", "");
+	conferirEspec ("20", "20");
+	conferirEspec ("2Mbps", "2Mbps");
+	conferirEspec ("1:4:0.5Mbps", "1Mbps,1.5Mbps,2Mbps,2.5Mbps,3Mbps,3.5Mbps,4Mbps");
+	conferirEspec ("0.1:0.3:0.1", "0.1,0.2,0.3");
+	conferirEspec ("1:3", "1,2,3");
+	conferirEspec ("5Mbps,1:2:1Mbps", "5Mbps,1Mbps,2Mbps");
+	conferirEspec ("log:1:100:3", "1,10,100");
+	conferirEspec ("5:1", "erro");
+	conferirEspec ("1:5:0", "erro");
+	conferirEspec ("log:0:10:3", "erro");
+	conferirEspec ("a:b", "erro");
+	conferirEspec ("1:2:3:4", "erro");
+
+	conferirEspecInteiro ("5:40:5", "5,10,15,20,25,30,35,40");
+	conferirEspecInteiro ("log:5:160:6", "5,10,20,40,80,160");
+	conferirEspecInteiro ("log:1:4:8", "1,2,3,4");
+	conferirEspecInteiro ("10,5,10", "10,5");
+	conferirEspecInteiro ("2Mbps", "erro");
+	conferirEspecInteiro ("0", "erro");
+}
+
+void verificarBootstrap (void) {
+	const uint32_t numFluxos = 13, n = 10;
+	uint64_t estado = 7;
+	std::vector<double> a (n * numFluxos), b (n * numFluxos), c (n * numFluxos);
+	for (uint32_t i = 0; i < n * numFluxos; i++) {
+		a[i] = sorteio (estado, 1e5, 1e6);
+		b[i] = sorteio (estado, 10.0, 50.0);
+		// fluxo 0 com denominador sempre zero: IC NaN
+		c[i] = i % numFluxos == 0 ? 0.0 : sorteio (estado, 0.0, 3.0);
+	}
+	std::vector<const double *> num, den;
+	num.push_back (&a[0]);
+	den.push_back (&b[0]);
+	num.push_back (&b[0]);
+	den.push_back (&c[0]);
+
+	OpcoesEstatistica o;
+	o.reamostras = 997;
+	o.threads = 1;
+	std::vector<double> inf1, sup1;
+	BootstrapRazoes (num, den, numFluxos, n, o, inf1, sup1);
+	for (uint32_t t = 2; t <= 8; t += 3) {
+		o.threads = t;
+		std::vector<double> inf, sup;
+		BootstrapRazoes (num, den, numFluxos, n, o, inf, sup);
+		for (uint32_t i = 0; i < inf.size (); i++) {
+			std::ostringstream oss;
+			oss << t << " threads, posicao " << i;
+			conferir (perto (inf[i], inf1[i], 0.0) && perto (sup[i], sup1[i], 0.0), "bootstrap", oss.str ());
+		}
+	}
+	conferir (std::isnan (inf1[numFluxos]) && std::isnan (sup1[numFluxos]), "bootstrap", "denominador zero");
+	for (uint32_t j = 0; j < numFluxos; j++) {
+		conferir (inf1[j] <= sup1[j], "bootstrap", "inf <= sup");
+	}
+}
+
+void verificarQuantil (void) {
+	// t(0,975; gl) de referência
+	const uint32_t gl[] = { 1, 2, 5, 10, 29, 30, 31, 40, 60, 120, 1000 };
+	const double t[] = { 12.706, 4.303, 2.571, 2.228, 2.045, 2.042, 2.0395, 2.0211, 2.0003, 1.9799, 1.9623 };
+	for (uint32_t i = 0; i < sizeof (gl) / sizeof (gl[0]); i++) {
+		std::ostringstream oss;
+		oss << "gl " << gl[i] << ": " << QuantilT975 (gl[i]);
+		conferir (std::fabs (QuantilT975 (gl[i]) - t[i]) < 1e-3, "quantil", oss.str ());
+	}
+	conferir (std::isnan (QuantilT975 (0)), "quantil", "gl 0");
+	conferir (std::isnan (MeiaLarguraT (1.0, 1)), "quantil", "n 1");
+	conferir (perto (MeiaLarguraT (2.0, 5), 2.776 * 2.0 / std::sqrt (5.0), 1e-12), "quantil", "meia largura");
+}
+
+
+int main (void) {
+	struct {
+		const char *nome;
+		void (*verificar) (void);
+	} verificacoes[] = {
+		{ "tabela", verificarTabela },
+		{ "espec", verificarEspec },
+		{ "bootstrap", verificarBootstrap },
+		{ "quantil", verificarQuantil }
+	};
+
+	std::cout << "Verificacao;Resultado;\n";
+	for (uint32_t i = 0; i < sizeof (verificacoes) / sizeof (verificacoes[0]); i++) {
+		uint32_t antes = g_falhas;
+		verificacoes[i].verificar ();
+		std::cout << verificacoes[i].nome << ";" << (g_falhas == antes ? "ok" : "falhou") << ";\n";
+	}
+
+	return g_falhas == 0 ? 0 : 1;
+}
@@ -0,0 +1,287 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef ASYNC_PCAP_H
+#define ASYNC_PCAP_H
+
+// Captura pcap assíncrona.
+//
+// O PcapHelper escreve cada quadro no arquivo dentro do callback do trace,
+// na thread da simulação. Aqui o callback só copia o quadro (até o snaplen)
+// para um ring buffer de produtor único/consumidor único e uma thread
+// escritora grava os arquivos. O ring tem tamanho fixo (o orçamento de
+// memória): se a escritora não acompanhar, o quadro é descartado e contado,
+// a simulação nunca bloqueia.
+
+#include "ns3/core-module.h"
+#include "ns3/network-module.h"
+#include "ns3/point-to-point-module.h"
+#include "ns3/wifi-module.h"
+#include <atomic>
+#include <thread>
+#include <chrono>
+#include <vector>
+#include <string>
+#include <sstream>
+#include <cstdio>
+#include <cstring>
+#include <stdint.h>
+
+namespace ns3 {
+
+class AsyncPcapWriter
+{
+public:
+	// Tipos de enlace do formato pcap
+	static const uint32_t DLT_PPP = 9;
+	static const uint32_t DLT_IEEE802_11 = 105;
+
+	// O ring precisa caber dois registros de tamanho máximo: um que não cabe
+	// no fim do ring pula para o início, e o preenchimento deixado no fim
+	// pode chegar a um registro inteiro
+	static uint64_t OrcamentoMinimo (uint32_t snaplen)
+	{
+		return 2 * Alinhar (sizeof (Registro) + (uint64_t) snaplen);
+	}
+
+	static bool Validar (uint64_t orcamentoBytes, uint32_t snaplen, std::string &erro)
+	{
+		if (snaplen == 0) {
+			erro = "snaplen deve ser maior que zero";
+			return false;
+		}
+		if (orcamentoBytes < OrcamentoMinimo (snaplen)) {
+			std::ostringstream oss;
+			oss << "pcapBudget de " << orcamentoBytes << " bytes nao cabe dois quadros de snaplen " << snaplen;
+			erro = oss.str ();
+			return false;
+		}
+		return true;
+	}
+
+	AsyncPcapWriter (uint64_t orcamentoBytes, uint32_t snaplen)
+		: m_capacidade (Alinhar (orcamentoBytes)),
+		  m_snaplen (snaplen),
+		  m_ring (new uint8_t[m_capacidade]),
+		  m_cabeca (0),
+		  m_cauda (0),
+		  m_rodando (false),
+		  m_capturados (0),
+		  m_descartados (0),
+		  m_bytesGravados (0)
+	{
+		NS_ABORT_MSG_IF (m_capacidade < OrcamentoMinimo (snaplen), "Ring do pcap assincrono menor que dois quadros");
+	}
+
+	~AsyncPcapWriter ()
+	{
+		Close ();
+		for (uint32_t i = 0; i < m_sinks.size (); i++) {
+			delete m_sinks[i];
+		}
+		delete [] m_ring;
+	}
+
+	// Captura os dois lados do enlace ponto-a-ponto, como EnablePcapAll.
+	void EnableP2p (std::string prefixo, NetDeviceContainer devices)
+	{
+		for (uint32_t i = 0; i < devices.GetN (); i++) {
+			Ptr<NetDevice> dev = devices.Get (i);
+			uint32_t idx = Abrir (NomeArquivo (prefixo, "p2p", dev), DLT_PPP);
+			dev->TraceConnectWithoutContext ("PromiscSniffer", MakeCallback (&Sink::Capturar, m_sinks[idx]));
+		}
+	}
+
+	// Quadros 802.11 transmitidos e recebidos pela PHY do dispositivo.
+	void EnableWifi (std::string prefixo, Ptr<NetDevice> dev)
+	{
+		Ptr<WifiPhy> phy = DynamicCast<WifiNetDevice> (dev)->GetPhy ();
+		uint32_t idx = Abrir (NomeArquivo (prefixo, "wifi", dev), DLT_IEEE802_11);
+		phy->TraceConnectWithoutContext ("PhyTxBegin", MakeCallback (&Sink::Capturar, m_sinks[idx]));
+		phy->TraceConnectWithoutContext ("PhyRxEnd", MakeCallback (&Sink::Capturar, m_sinks[idx]));
+	}
+
+	void Start (void)
+	{
+		if (!m_rodando) {
+			m_rodando = true;
+			m_escritora = std::thread (&AsyncPcapWriter::Escrever, this);
+		}
+	}
+
+	// Esvazia o ring, fecha os arquivos e imprime o resumo em std::cerr.
+	void Close (void)
+	{
+		if (m_rodando) {
+			m_rodando = false;
+			m_escritora.join ();
+		}
+		for (uint32_t i = 0; i < m_arquivos.size (); i++) {
+			if (m_arquivos[i] != 0) {
+				fclose (m_arquivos[i]);
+				m_arquivos[i] = 0;
+			}
+		}
+	}
+
+	void PrintStats (std::ostream &os, uint32_t nWifi, uint32_t k)
+	{
+		os << "pcap;" << nWifi << ";" << k
+		   << ";capturados=" << m_capturados
+		   << ";descartados=" << m_descartados
+		   << ";bytes=" << m_bytesGravados
+		   << "\n";
+	}
+
+private:
+	// Registro no ring, seguido de capLen bytes e alinhado em 8 bytes.
+	// arquivo == kVolta marca o fim útil do ring (o resto é preenchimento).
+	struct Registro {
+		uint32_t arquivo;
+		uint32_t tsSec;
+		uint32_t tsUsec;
+		uint32_t origLen;
+		uint32_t capLen;
+		uint32_t reservado;
+	};
+	static const uint32_t kVolta = 0xffffffff;
+
+	struct Sink {
+		AsyncPcapWriter *writer;
+		uint32_t arquivo;
+
+		void Capturar (Ptr<const Packet> p)
+		{
+			writer->Enfileirar (arquivo, p);
+		}
+	};
+
+	static std::string NomeArquivo (std::string prefixo, std::string tipo, Ptr<NetDevice> dev)
+	{
+		std::ostringstream oss;
+		oss << prefixo << "-" << tipo << "-" << dev->GetNode ()->GetId () << "-" << dev->GetIfIndex () << ".pcap";
+		return oss.str ();
+	}
+
+	uint32_t Abrir (std::string nome, uint32_t linkType)
+	{
+		FILE *f = fopen (nome.c_str (), "wb");
+		NS_ABORT_MSG_IF (f == 0, "Nao foi possivel abrir " << nome);
+
+		uint32_t cabecalho[6] = { 0xa1b2c3d4, 0x00040002, 0, 0, m_snaplen, linkType };
+		fwrite (cabecalho, sizeof (cabecalho), 1, f);
+
+		Sink *s = new Sink;
+		s->writer = this;
+		s->arquivo = m_arquivos.size ();
+		m_sinks.push_back (s);
+		m_arquivos.push_back (f);
+		return s->arquivo;
+	}
+
+	static uint64_t Alinhar (uint64_t n)
+	{
+		return (n + 7) & ~(uint64_t) 7;
+	}
+
+	// Produtor: thread da simulação.
+	void Enfileirar (uint32_t arquivo, Ptr<const Packet> p)
+	{
+		uint32_t origLen = p->GetSize ();
+		uint32_t capLen = origLen < m_snaplen ? origLen : m_snaplen;
+		uint64_t necessario = Alinhar (sizeof (Registro) + capLen);
+
+		uint64_t cabeca = m_cabeca.load (std::memory_order_relaxed);
+		uint64_t livre = m_capacidade - (cabeca - m_cauda.load (std::memory_order_acquire));
+		uint64_t pos = cabeca % m_capacidade;
+		uint64_t contiguo = m_capacidade - pos;
+		uint64_t preenchimento = contiguo < necessario ? contiguo : 0;
+
+		if (necessario + preenchimento > livre) {
+			m_descartados++;
+			return;
+		}
+		if (preenchimento > 0) {
+			((Registro *) (m_ring + pos))->arquivo = kVolta;
+			cabeca += preenchimento;
+			pos = 0;
+		}
+
+		Registro *r = (Registro *) (m_ring + pos);
+		Time agora = Simulator::Now ();
+		int64_t us = agora.GetMicroSeconds ();
+		r->arquivo = arquivo;
+		r->tsSec = (uint32_t) (us / 1000000);
+		r->tsUsec = (uint32_t) (us % 1000000);
+		r->origLen = origLen;
+		r->capLen = capLen;
+		p->CopyData (m_ring + pos + sizeof (Registro), capLen);
+
+		m_capturados++;
+		m_cabeca.store (cabeca + necessario, std::memory_order_release);
+	}
+
+	// Consumidor: thread escritora.
+	void Escrever (void)
+	{
+		while (true) {
+			bool ultimaPassada = !m_rodando.load (std::memory_order_acquire);
+			uint64_t cabeca = m_cabeca.load (std::memory_order_acquire);
+			uint64_t cauda = m_cauda.load (std::memory_order_relaxed);
+
+			while (cauda != cabeca) {
+				uint64_t pos = cauda % m_capacidade;
+				Registro *r = (Registro *) (m_ring + pos);
+				if (r->arquivo == kVolta) {
+					cauda += m_capacidade - pos;
+					continue;
+				}
+				uint32_t cabecalho[4] = { r->tsSec, r->tsUsec, r->capLen, r->origLen };
+				FILE *f = m_arquivos[r->arquivo];
+				fwrite (cabecalho, sizeof (cabecalho), 1, f);
+				fwrite (m_ring + pos + sizeof (Registro), r->capLen, 1, f);
+				m_bytesGravados += sizeof (cabecalho) + r->capLen;
+
+				cauda += Alinhar (sizeof (Registro) + r->capLen);
+				m_cauda.store (cauda, std::memory_order_release);
+			}
+
+			if (ultimaPassada) {
+				break;
+			}
+			std::this_thread::sleep_for (std::chrono::milliseconds (1));
+		}
+	}
+
+	uint64_t m_capacidade;
+	uint32_t m_snaplen;
+	uint8_t *m_ring;
+	std::atomic<uint64_t> m_cabeca;
+	std::atomic<uint64_t> m_cauda;
+	std::atomic<bool> m_rodando;
+	std::thread m_escritora;
+
+	std::vector<FILE *> m_arquivos;
+	std::vector<Sink *> m_sinks;
+
+	uint64_t m_capturados;
+	uint64_t m_descartados;
+	uint64_t m_bytesGravados;
+};
+
+} // namespace ns3
+
+#endif /* ASYNC_PCAP_H */
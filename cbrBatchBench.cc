@@ -0,0 +1,114 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "ns3/core-module.h"
+#include "ns3/network-module.h"
+#include "ns3/internet-module.h"
+#include "ns3/applications-module.h"
+#include "cbrSource.h"
+#include <sys/time.h>
+
+// Benchmark do cbrSource.h: conta os eventos de envio com e sem lote.
+//
+// Cada estação manda 450 bytes a cada 3.824 ms para o próprio loopback, sem
+// MAC/PHY, de forma que a diferença de eventos vem só das fontes. Os pacotes
+// enviados são os mesmos nos dois modos; só muda quantos eventos os disparam.
+//
+// Obs:
+// executar comando : ./waf --run "cbrBatchBench --batched=0" e "--batched=1"
+
+
+using namespace ns3;
+using namespace std;
+
+NS_LOG_COMPONENT_DEFINE ("CbrBatchBenchProgram");
+
+
+double agora (void) {
+	struct timeval tv;
+	gettimeofday (&tv, 0);
+	return tv.tv_sec + tv.tv_usec / 1e6;
+}
+
+
+int main (int argc, char *argv[]) {
+	uint32_t nWifi = 40;
+	bool batched = true;
+	double timeInterval = 0.003824;
+	uint64_t packetSize = 450;
+	float tempoExecucao = 10.0;
+
+	CommandLine cmd;
+	cmd.AddValue ("nWifi", "Number of CBR sources", nWifi);
+	cmd.AddValue ("batched", "Group simultaneous sends into one event", batched);
+	cmd.AddValue ("tempoExecucao", "Simulated seconds", tempoExecucao);
+	cmd.Parse (argc,argv);
+
+	NodeContainer nodes;
+	nodes.Create (nWifi);
+
+	InternetStackHelper stack;
+	stack.Install (nodes);
+
+	PacketSinkHelper sink ("ns3::UdpSocketFactory", InetSocketAddress (Ipv4Address::GetAny (), 200));
+	ApplicationContainer serverApps = sink.Install (nodes);
+	serverApps.Start (Seconds (1.0));
+	serverApps.Stop (Seconds (tempoExecucao));
+
+	CbrSourceHelper cbr (InetSocketAddress (Ipv4Address::GetLoopback (), 200));
+	cbr.SetAttribute ("Interval", TimeValue (Seconds (timeInterval)));
+	cbr.SetAttribute ("PacketSize", UintegerValue (packetSize));
+	cbr.SetAttribute ("Batched", BooleanValue (batched));
+
+	ApplicationContainer clientApps;
+	for (uint32_t i = 0; i < nWifi; i++) {
+		clientApps.Add(cbr.Install (nodes.Get (i)));
+	}
+	clientApps.Start (Seconds (2.0));
+	clientApps.Stop (Seconds (tempoExecucao));
+
+	Simulator::Stop (Seconds (tempoExecucao));
+
+	double inicio = agora ();
+	Simulator::Run ();
+	double duracao = agora () - inicio;
+
+	uint64_t pacotes = 0;
+	for (uint32_t i = 0; i < clientApps.GetN (); i++) {
+		pacotes += DynamicCast<CbrSourceApplication> (clientApps.Get (i))->GetSent ();
+	}
+	uint64_t eventosEnvio = batched ? CbrBatchScheduler::Get ()->GetLotes () : pacotes;
+
+	std::cout << "Batched;";
+	std::cout << "NWifi;";
+	std::cout << "Pacotes;";
+	std::cout << "EventosEnvio;";
+	std::cout << "EventosTotal;";
+	std::cout << "Tempo(s);";
+	std::cout << "\n";
+
+	std::cout << batched << ";";
+	std::cout << nWifi << ";";
+	std::cout << pacotes << ";";
+	std::cout << eventosEnvio << ";";
+	std::cout << Simulator::GetEventCount () << ";";
+	std::cout << duracao << ";";
+	std::cout << "\n";
+
+	Simulator::Destroy ();
+
+	return 0;
+}
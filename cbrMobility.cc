@@ -24,6 +24,7 @@
 #include "ns3/internet-module.h"
 #include "ns3/flow-monitor-module.h"
 #include "ns3/netanim-module.h"
+#include "flowIndex.h"
 #include <sstream>
 
 // Default Network Topology
@@ -247,7 +248,8 @@ int main (int argc, char *argv[]) {
 
 			address.SetBase ("192.168.0.0", "255.255.255.0");
 			address.Assign (apDevices);
-			address.Assign (staDevices);
+			Ipv4InterfaceContainer staInterfaces;
+			staInterfaces = address.Assign (staDevices);
 
 			PacketSinkHelper  echoServer ("ns3::UdpSocketFactory", InetSocketAddress (p2pInterfaces.GetAddress (1), 200));
 
@@ -296,43 +298,52 @@ int main (int argc, char *argv[]) {
 			flowMonitor->CheckForLostPackets();
 			Ptr<Ipv4FlowClassifier> classifier = DynamicCast<Ipv4FlowClassifier>(flowHelper.GetClassifier());
 			FlowMonitor::FlowStatsContainer stats = flowMonitor->GetFlowStats ();
+
+			/*Classifica cada FlowId uma vez (estação, sentido, porta); o laço não consulta mais o classifier*/
+			FlowIndex flowIndex (staInterfaces);
+			flowIndex.Construir (classifier, stats);
+
 			for (std::map<FlowId, FlowMonitor::FlowStats>::const_iterator i = stats.begin (); i != stats.end (); ++i)
 			{
-				Ipv4FlowClassifier::FiveTuple t = classifier->FindFlow (i->first);
+				const FlowClass &c = flowIndex.Get (i->first);
+				if (!c.valido || c.direcao != FLUXO_DADOS) {
+					continue;
+				}
+				uint32_t slot = c.estacao;
 
 				if(k==1){
-					source[i->first-1] = t.sourceAddress;
-					destination[i->first-1] = t.destinationAddress;
+					source[slot] = c.tupla.sourceAddress;
+					destination[slot] = c.tupla.destinationAddress;
 				}
 
 
 				/*Soma os valores de cada repetição de cada nó para depois calcular a média*/
-				timeFirstTxPacketMR[i->first-1] += i->second.timeFirstTxPacket.GetSeconds();
-				timeFirstRxPacketMR[i->first-1] += i->second.timeFirstRxPacket.GetSeconds();
-				timeLastTxPacketMR[i->first-1] += i->second.timeLastTxPacket.GetSeconds();
-				timeLastRxPacketMR[i->first-1] += i->second.timeLastRxPacket.GetSeconds();
-				delaySumMR[i->first-1] += i->second.delaySum.GetSeconds();
-				jitterSumMR[i->first-1] += i->second.jitterSum.GetSeconds();
-				lastDelayMR[i->first-1] += i->second.lastDelay.GetSeconds();
-				txBytesMR[i->first-1] += i->second.txBytes;
-				rxBytesMR[i->first-1] += i->second.rxBytes;
-				txPacketsMR[i->first-1] += i->second.txPackets;
-				rxPacketsMR[i->first-1] += i->second.rxPackets;
-				lostPacketsMR[i->first-1] += i->second.lostPackets;
+				timeFirstTxPacketMR[slot] += i->second.timeFirstTxPacket.GetSeconds();
+				timeFirstRxPacketMR[slot] += i->second.timeFirstRxPacket.GetSeconds();
+				timeLastTxPacketMR[slot] += i->second.timeLastTxPacket.GetSeconds();
+				timeLastRxPacketMR[slot] += i->second.timeLastRxPacket.GetSeconds();
+				delaySumMR[slot] += i->second.delaySum.GetSeconds();
+				jitterSumMR[slot] += i->second.jitterSum.GetSeconds();
+				lastDelayMR[slot] += i->second.lastDelay.GetSeconds();
+				txBytesMR[slot] += i->second.txBytes;
+				rxBytesMR[slot] += i->second.rxBytes;
+				txPacketsMR[slot] += i->second.txPackets;
+				rxPacketsMR[slot] += i->second.rxPackets;
+				lostPacketsMR[slot] += i->second.lostPackets;
 
 				/*Guarda o valor de cada nó para depois calcular o desvio padrão*/
-				timeFirstTxPacketNO[i->first-1][k-1] = i->second.timeFirstTxPacket.GetSeconds();
-				timeFirstRxPacketNO[i->first-1][k-1] = i->second.timeFirstRxPacket.GetSeconds();
-				timeLastTxPacketNO[i->first-1][k-1] = i->second.timeLastTxPacket.GetSeconds();
-				timeLastRxPacketNO[i->first-1][k-1] = i->second.timeLastRxPacket.GetSeconds();
-				delaySumNO[i->first-1][k-1] = i->second.delaySum.GetSeconds();
-				jitterSumNO[i->first-1][k-1] = i->second.jitterSum.GetSeconds();
-				lastDelayNO[i->first-1][k-1] = i->second.lastDelay.GetSeconds();
-				txBytesNO[i->first-1][k-1] = i->second.txBytes;
-				rxBytesNO[i->first-1][k-1] = i->second.rxBytes;
-				txPacketsNO[i->first-1][k-1] = i->second.txPackets;
-				rxPacketsNO[i->first-1][k-1] = i->second.rxPackets;
-				lostPacketsNO[i->first-1][k-1] = i->second.lostPackets;
+				timeFirstTxPacketNO[slot][k-1] = i->second.timeFirstTxPacket.GetSeconds();
+				timeFirstRxPacketNO[slot][k-1] = i->second.timeFirstRxPacket.GetSeconds();
+				timeLastTxPacketNO[slot][k-1] = i->second.timeLastTxPacket.GetSeconds();
+				timeLastRxPacketNO[slot][k-1] = i->second.timeLastRxPacket.GetSeconds();
+				delaySumNO[slot][k-1] = i->second.delaySum.GetSeconds();
+				jitterSumNO[slot][k-1] = i->second.jitterSum.GetSeconds();
+				lastDelayNO[slot][k-1] = i->second.lastDelay.GetSeconds();
+				txBytesNO[slot][k-1] = i->second.txBytes;
+				rxBytesNO[slot][k-1] = i->second.rxBytes;
+				txPacketsNO[slot][k-1] = i->second.txPackets;
+				rxPacketsNO[slot][k-1] = i->second.rxPackets;
+				lostPacketsNO[slot][k-1] = i->second.lostPackets;
 			}
 
 
@@ -24,6 +24,7 @@
 #include "ns3/internet-module.h"
 #include "ns3/flow-monitor-module.h"
 #include "ns3/netanim-module.h"
+#include "flowIndex.h"
 #include <sstream>
 
 // Default Network Topology
@@ -111,60 +112,6 @@ int main (int argc, char *argv[]) {
 
 		uint32_t nWifi = z * 5;
 
-
-		/*
-		Ipv4Address source[nWifi];
-		Ipv4Address destination[nWifi];
-
-
-		//Variáveis que acumulam a soma para depois calcular a média
-		double timeFirstTxPacketMR[nWifi];
-		double timeFirstRxPacketMR[nWifi];
-		double timeLastTxPacketMR[nWifi];
-		double timeLastRxPacketMR[nWifi];
-		double delaySumMR[nWifi];
-		double jitterSumMR[nWifi];
-		double lastDelayMR[nWifi];
-
-		uint64_t txBytesMR[nWifi];
-		uint64_t rxBytesMR[nWifi];
-		uint64_t txPacketsMR[nWifi];
-		uint64_t rxPacketsMR[nWifi];
-		uint64_t lostPacketsMR[nWifi];
-
-		for(uint32_t j = 0; j < nWifi; j++) {
-			timeFirstTxPacketMR[j] = 0.0;
-			timeFirstRxPacketMR[j] = 0.0;
-			timeLastTxPacketMR[j] = 0.0;
-			timeLastRxPacketMR[j] = 0.0;
-			delaySumMR[j] = 0.0;
-			jitterSumMR[j] = 0.0;
-			lastDelayMR[j] = 0.0;
-			txBytesMR[j] = 0;
-			rxBytesMR[j] = 0;
-			txPacketsMR[j] = 0;
-			rxPacketsMR[j] = 0;
-			lostPacketsMR[j] = 0;
-		}
-
-
-		//Variáveis para armazenar o valor de cada NÓ para depois calcular o desvio padrão
-		double timeFirstTxPacketNO[nWifi][repeticao];
-		double timeFirstRxPacketNO[nWifi][repeticao];
-		double timeLastTxPacketNO[nWifi][repeticao];
-		double timeLastRxPacketNO[nWifi][repeticao];
-		double delaySumNO[nWifi][repeticao];
-		double jitterSumNO[nWifi][repeticao];
-		double lastDelayNO[nWifi][repeticao];
-
-		uint64_t txBytesNO[nWifi][repeticao];
-		uint64_t rxBytesNO[nWifi][repeticao];
-		uint64_t txPacketsNO[nWifi][repeticao];
-		uint64_t rxPacketsNO[nWifi][repeticao];
-		uint64_t lostPacketsNO[nWifi][repeticao];
-
-		*/
-
 		for (uint32_t k = 1; k <= repeticao; k++) {
 			cmd.AddValue ("nWifi", "Number of wifi STA devices", nWifi);
 
@@ -264,7 +211,8 @@ int main (int argc, char *argv[]) {
 
 			address.SetBase ("192.168.0.0", "255.255.255.0");
 			address.Assign (apDevices);
-			address.Assign (staDevices);
+			Ipv4InterfaceContainer staInterfaces;
+			staInterfaces = address.Assign (staDevices);
 
 			PacketSinkHelper  echoServer ("ns3::UdpSocketFactory", InetSocketAddress (p2pInterfaces.GetAddress (1), 200));
 
@@ -341,16 +289,14 @@ int main (int argc, char *argv[]) {
 			flowMonitor->CheckForLostPackets();
 			Ptr<Ipv4FlowClassifier> classifier = DynamicCast<Ipv4FlowClassifier>(flowHelper.GetClassifier());
 			FlowMonitor::FlowStatsContainer stats = flowMonitor->GetFlowStats ();
+
+			/*Classifica cada FlowId uma vez; o laço não consulta mais o classifier*/
+			FlowIndex flowIndex (staInterfaces);
+			flowIndex.Construir (classifier, stats);
+
 			for (std::map<FlowId, FlowMonitor::FlowStats>::const_iterator i = stats.begin (); i != stats.end (); ++i)
 			{
-				Ipv4FlowClassifier::FiveTuple t = classifier->FindFlow (i->first);
-
-				/*
-				if(k==1){
-					source[i->first-1] = t.sourceAddress;
-					destination[i->first-1] = t.destinationAddress;
-				}
-				*/
+				const Ipv4FlowClassifier::FiveTuple &t = flowIndex.Get (i->first).tupla;
 
 
 				std::cout << nWifi << ";";
@@ -381,36 +327,6 @@ int main (int argc, char *argv[]) {
 				std::cout << (1.0) * i->second.lostPackets/(i->second.rxPackets+i->second.lostPackets) << ";";
 
 				std::cout << "\n";
-
-				/*
-				//Soma os valores de cada repetição de cada nó para depois calcular a média
-				timeFirstTxPacketMR[i->first-1] += i->second.timeFirstTxPacket.GetSeconds();
-				timeFirstRxPacketMR[i->first-1] += i->second.timeFirstRxPacket.GetSeconds();
-				timeLastTxPacketMR[i->first-1] += i->second.timeLastTxPacket.GetSeconds();
-				timeLastRxPacketMR[i->first-1] += i->second.timeLastRxPacket.GetSeconds();
-				delaySumMR[i->first-1] += i->second.delaySum.GetSeconds();
-				jitterSumMR[i->first-1] += i->second.jitterSum.GetSeconds();
-				lastDelayMR[i->first-1] += i->second.lastDelay.GetSeconds();
-				txBytesMR[i->first-1] += i->second.txBytes;
-				rxBytesMR[i->first-1] += i->second.rxBytes;
-				txPacketsMR[i->first-1] += i->second.txPackets;
-				rxPacketsMR[i->first-1] += i->second.rxPackets;
-				lostPacketsMR[i->first-1] += i->second.lostPackets;
-
-				//Guarda o valor de cada nó para depois calcular o desvio padrão
-				timeFirstTxPacketNO[i->first-1][k-1] = i->second.timeFirstTxPacket.GetSeconds();
-				timeFirstRxPacketNO[i->first-1][k-1] = i->second.timeFirstRxPacket.GetSeconds();
-				timeLastTxPacketNO[i->first-1][k-1] = i->second.timeLastTxPacket.GetSeconds();
-				timeLastRxPacketNO[i->first-1][k-1] = i->second.timeLastRxPacket.GetSeconds();
-				delaySumNO[i->first-1][k-1] = i->second.delaySum.GetSeconds();
-				jitterSumNO[i->first-1][k-1] = i->second.jitterSum.GetSeconds();
-				lastDelayNO[i->first-1][k-1] = i->second.lastDelay.GetSeconds();
-				txBytesNO[i->first-1][k-1] = i->second.txBytes;
-				rxBytesNO[i->first-1][k-1] = i->second.rxBytes;
-				txPacketsNO[i->first-1][k-1] = i->second.txPackets;
-				rxPacketsNO[i->first-1][k-1] = i->second.rxPackets;
-				lostPacketsNO[i->first-1][k-1] = i->second.lostPackets;
-				*/
 			}
 
 
@@ -0,0 +1,154 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef CBR_POLICY_H
+#define CBR_POLICY_H
+
+// Política de tráfego TrafegoCbr do Cenario (scenario.h): UDP a taxa
+// constante das estações para um PacketSink no servidor, pelo
+// UdpEchoClient, pelo CbrSource ou reproduzindo um trace.
+// --cbrBatch usa o CbrSource com os envios simultâneos agrupados; com
+// cbrJitter, cbrOffset ou inicio diferente de fixo os envios não coincidem
+// e o agrupamento fica desligado.
+
+#include "scenario.h"
+#include "traceReplay.h"
+#include "cbrSource.h"
+#include <sstream>
+
+namespace ns3 {
+
+struct TrafegoCbr {
+	struct Opcoes {
+		uint64_t maxPackets;
+		double timeInterval;   // sem dataRate
+		std::string traceFile;
+		uint32_t traceFlows;
+		bool cbrSource;
+		bool cbrBatch;
+		double cbrJitter;
+		double cbrOffset;
+
+		Opcoes ()
+			: maxPackets (1000000),
+			  timeInterval (0.003824),
+			  traceFile (""),
+			  traceFlows (0),
+			  cbrSource (false),
+			  cbrBatch (false),
+			  cbrJitter (0.0),
+			  cbrOffset (0.0)
+		{
+		}
+	};
+
+	/*Padrão: 5 a 40 estações de 5 em 5, como o antigo laço z*/
+	static OpcoesVarredura Varredura (const std::string &nome)
+	{
+		return OpcoesVarredura (nome, "5:40:5", "450", "", "5Mbps");
+	}
+
+	static void Registrar (CommandLine &cmd, Opcoes &o, OpcoesVarredura &varredura)
+	{
+		cmd.AddValue ("traceFile", "Replay this binary trace instead of the CBR echo client", o.traceFile);
+		cmd.AddValue ("traceFlows", "Station i replays flow i % traceFlows of the trace (0 = whole trace)", o.traceFlows);
+		cmd.AddValue ("cbrSource", "Use the lightweight CbrSourceApplication instead of the echo client", o.cbrSource);
+		cmd.AddValue ("cbrBatch", "Use CbrSourceApplication with simultaneous sends grouped in one event", o.cbrBatch);
+		cmd.AddValue ("cbrRate", "Same as dataRate (kept for older scripts)", varredura.espec.dataRate);
+		cmd.AddValue ("cbrJitter", "CbrSource per-packet jitter, uniform in [0, cbrJitter] seconds", o.cbrJitter);
+		cmd.AddValue ("cbrOffset", "CbrSource start offsets spread over [0, cbrOffset) seconds across stations", o.cbrOffset);
+	}
+
+	static void Descrever (std::ostream &os, const Opcoes &o)
+	{
+		os << "\nmaxPackets=" << o.maxPackets << "\ntimeInterval=" << o.timeInterval
+			<< "\ntraceFile=" << o.traceFile << "\ntraceFlows=" << o.traceFlows
+			<< "\ncbrSource=" << o.cbrSource << "\ncbrBatch=" << o.cbrBatch
+			<< "\ncbrJitter=" << o.cbrJitter << "\ncbrOffset=" << o.cbrOffset;
+	}
+
+	static void Configurar (void)
+	{
+	}
+
+	static void AtivarLog (void)
+	{
+		LogComponentEnable ("UdpEchoClientApplication", LOG_LEVEL_INFO);
+		LogComponentEnable ("PacketSink", LOG_LEVEL_INFO);
+	}
+
+	/*Com dataRate o intervalo do echo client sai da taxa: packetSize * 8 / dataRate*/
+	static Time Intervalo (const ParametrosCenario &p, const Opcoes &o)
+	{
+		if (p.dataRate.empty ()) {
+			return Seconds (o.timeInterval);
+		}
+		return Seconds (p.packetSize * 8.0 / DataRate (p.dataRate).GetBitRate ());
+	}
+
+	// Lote só entre fontes que enviam no mesmo instante
+	static bool EmLote (const ParametrosCenario &p, const Opcoes &o)
+	{
+		return o.cbrBatch && o.cbrJitter <= 0.0 && o.cbrOffset <= 0.0 && p.inicio.distribuicao == "fixo";
+	}
+
+	static void Instalar (const ParametrosCenario &p, const Opcoes &o, Ptr<Node> servidor, Ipv4Address endereco,
+			const NodeContainer &estacoes, ApplicationContainer &serverApps, ApplicationContainer &clientApps)
+	{
+		PacketSinkHelper  echoServer ("ns3::UdpSocketFactory", InetSocketAddress (endereco, 200));
+		serverApps.Add (echoServer.Install (servidor));
+
+		UdpEchoClientHelper echoClient (endereco, 200);
+		echoClient.SetAttribute ("MaxPackets", UintegerValue (o.maxPackets));
+		echoClient.SetAttribute ("Interval", TimeValue (Intervalo (p, o)));
+		echoClient.SetAttribute ("PacketSize", UintegerValue (p.packetSize));
+
+		CbrSourceHelper cbrHelper (InetSocketAddress (endereco, 200));
+		cbrHelper.SetAttribute ("MaxPackets", UintegerValue (o.maxPackets));
+		cbrHelper.SetAttribute ("Interval", TimeValue (Seconds (o.timeInterval)));
+		cbrHelper.SetAttribute ("PacketSize", UintegerValue (p.packetSize));
+		cbrHelper.SetAttribute ("Batched", BooleanValue (EmLote (p, o)));
+		if (!p.dataRate.empty ()) {
+			cbrHelper.SetAttribute ("DataRate", DataRateValue (DataRate (p.dataRate)));
+		}
+		if (o.cbrJitter > 0.0) {
+			std::ostringstream jitter;
+			jitter << "ns3::UniformRandomVariable[Min=0.0|Max=" << o.cbrJitter << "]";
+			cbrHelper.SetAttribute ("Jitter", StringValue (jitter.str ()));
+		}
+
+		TraceReplayHelper replay ("ns3::UdpSocketFactory", InetSocketAddress (endereco, 200), o.traceFile);
+
+		uint32_t nWifi = estacoes.GetN ();
+		for (uint32_t i = 0; i < nWifi; i++) {
+			if (!o.traceFile.empty ()) {
+				if (o.traceFlows > 0) {
+					replay.SetAttribute ("Flow", UintegerValue (i % o.traceFlows));
+				}
+				clientApps.Add(replay.Install (estacoes.Get (i)));
+			} else if (o.cbrSource || o.cbrBatch) {
+				cbrHelper.SetAttribute ("StartOffset", TimeValue (Seconds (o.cbrOffset * i / nWifi)));
+				clientApps.Add(cbrHelper.Install (estacoes.Get (i)));
+			} else {
+				clientApps.Add(echoClient.Install (estacoes.Get (i)));
+			}
+		}
+	}
+};
+
+} // namespace ns3
+
+#endif /* CBR_POLICY_H */
@@ -0,0 +1,398 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef CBR_SOURCE_H
+#define CBR_SOURCE_H
+
+// Fonte CBR UDP leve com emissão em lote.
+//
+// Substitui o UdpEchoClient + PacketSink dos cenários CBR: não abre caminho
+// de recepção nem guarda estado de eco, só o socket, o instante de início e
+// o número de pacotes enviados. Taxa (ou intervalo), tamanho, jitter por
+// pacote e deslocamento de início são atributos.
+//
+// O UdpEchoClient agenda um evento por pacote por estação: com 40 estações a
+// cada 3.824 ms são 40 eventos no mesmo instante. Com Batched (desligado por
+// padrão) as fontes se registram
+// num CbrBatchScheduler, que mantém um único evento pendente no próximo
+// instante de envio e, quando ele dispara, envia os pacotes de todas as
+// fontes com envio marcado para aquele instante exato. Os instantes são
+// calculados pela fonte (início + n * intervalo), então o tempo de cada
+// pacote é o mesmo do modo um-evento-por-pacote.
+//
+// Um socket do ns-3 não aceita pacote com horário de saída futuro, por isso
+// o lote é formado entre fontes que coincidem no tempo e não adiantando os
+// próximos K pacotes de uma mesma fonte (isso mudaria o tempo de saída).
+// Só compensa quando as fontes coincidem: com jitter ou inícios deslocados
+// cada lote tem um pacote só e o scheduler é custo a mais.
+
+#include "ns3/core-module.h"
+#include "ns3/network-module.h"
+#include "ns3/internet-module.h"
+#include <queue>
+#include <vector>
+
+namespace ns3 {
+
+class CbrSourceApplication;
+
+class CbrBatchScheduler
+{
+public:
+	// Um por simulação; liberado no Simulator::Destroy.
+	static CbrBatchScheduler *Get (void)
+	{
+		if (Instancia () == 0) {
+			Instancia () = new CbrBatchScheduler;
+			Simulator::ScheduleDestroy (&CbrBatchScheduler::Destruir);
+		}
+		return Instancia ();
+	}
+
+	void Agendar (Ptr<CbrSourceApplication> app, Time quando);
+
+	uint64_t GetLotes (void) const
+	{
+		return m_lotes;
+	}
+
+	uint64_t GetEnvios (void) const
+	{
+		return m_envios;
+	}
+
+private:
+	struct Pendente {
+		Time quando;
+		uint64_t ordem;
+		uint32_t geracao;
+		Ptr<CbrSourceApplication> app;
+
+		bool Valido (void) const;
+
+		bool operator< (const Pendente &o) const
+		{
+			// priority_queue é max-heap
+			return quando != o.quando ? quando > o.quando : ordem > o.ordem;
+		}
+	};
+
+	CbrBatchScheduler ()
+		: m_ordem (0),
+		  m_lotes (0),
+		  m_envios (0)
+	{
+	}
+
+	static CbrBatchScheduler *&Instancia (void)
+	{
+		static CbrBatchScheduler *instancia = 0;
+		return instancia;
+	}
+
+	static void Destruir (void)
+	{
+		delete Instancia ();
+		Instancia () = 0;
+	}
+
+	void Disparar (void);
+
+	std::priority_queue<Pendente> m_fila;
+	EventId m_evento;
+	Time m_quandoEvento;
+	uint64_t m_ordem;
+	uint64_t m_lotes;
+	uint64_t m_envios;
+};
+
+
+class CbrSourceApplication : public Application
+{
+public:
+	static TypeId GetTypeId (void)
+	{
+		static TypeId tid = TypeId ("ns3::CbrSourceApplication")
+			.SetParent<Application> ()
+			.AddConstructor<CbrSourceApplication> ()
+			.AddAttribute ("Remote", "The address of the destination.",
+					AddressValue (),
+					MakeAddressAccessor (&CbrSourceApplication::m_peer),
+					MakeAddressChecker ())
+			.AddAttribute ("PacketSize", "Size of each UDP payload in bytes.",
+					UintegerValue (450),
+					MakeUintegerAccessor (&CbrSourceApplication::m_tamanho),
+					MakeUintegerChecker<uint32_t> (1))
+			.AddAttribute ("Interval", "Time between packets.",
+					TimeValue (Seconds (0.003824)),
+					MakeTimeAccessor (&CbrSourceApplication::m_intervalo),
+					MakeTimeChecker ())
+			.AddAttribute ("DataRate", "If non-zero, overrides Interval with PacketSize * 8 / DataRate.",
+					DataRateValue (DataRate ("0bps")),
+					MakeDataRateAccessor (&CbrSourceApplication::m_taxa),
+					MakeDataRateChecker ())
+			.AddAttribute ("Jitter", "Delay added to each nominal send time, in seconds (kept below one interval).",
+					StringValue ("ns3::ConstantRandomVariable[Constant=0.0]"),
+					MakePointerAccessor (&CbrSourceApplication::m_jitter),
+					MakePointerChecker<RandomVariableStream> ())
+			.AddAttribute ("StartOffset", "Delay between StartApplication and the first packet.",
+					TimeValue (Seconds (0.0)),
+					MakeTimeAccessor (&CbrSourceApplication::m_deslocamento),
+					MakeTimeChecker ())
+			.AddAttribute ("MaxPackets", "Stop after this many packets (0 = no limit).",
+					UintegerValue (0),
+					MakeUintegerAccessor (&CbrSourceApplication::m_maxPacotes),
+					MakeUintegerChecker<uint64_t> ())
+			.AddAttribute ("Batched", "Share send events with other sources through the CbrBatchScheduler.",
+					BooleanValue (false),
+					MakeBooleanAccessor (&CbrSourceApplication::m_emLote),
+					MakeBooleanChecker ());
+		return tid;
+	}
+
+	CbrSourceApplication ()
+		: m_tamanho (450),
+		  m_maxPacotes (0),
+		  m_emLote (false),
+		  m_ativo (false),
+		  m_geracao (0),
+		  m_enviados (0)
+	{
+	}
+
+	virtual ~CbrSourceApplication ()
+	{
+	}
+
+	bool IsAtivo (void) const
+	{
+		return m_ativo;
+	}
+
+	// Incrementado a cada Start, invalida entradas antigas no scheduler.
+	uint32_t GetGeracao (void) const
+	{
+		return m_geracao;
+	}
+
+	uint64_t GetSent (void) const
+	{
+		return m_enviados;
+	}
+
+	int64_t AssignStreams (int64_t stream)
+	{
+		m_jitter->SetStream (stream);
+		return 1;
+	}
+
+	// Envia o pacote marcado para agora e devolve o instante do próximo,
+	// ou um Time negativo se a fonte terminou.
+	Time Enviar (void)
+	{
+		m_socket->Send (Create<Packet> (m_tamanho));
+		m_enviados++;
+		if (m_maxPacotes != 0 && m_enviados >= m_maxPacotes) {
+			m_ativo = false;
+			return Seconds (-1.0);
+		}
+		return Instante (m_enviados);
+	}
+
+protected:
+	virtual void DoDispose (void)
+	{
+		m_socket = 0;
+		Application::DoDispose ();
+	}
+
+private:
+	virtual void StartApplication (void)
+	{
+		if (m_socket == 0) {
+			m_socket = Socket::CreateSocket (GetNode (), UdpSocketFactory::GetTypeId ());
+			m_socket->Bind ();
+			m_socket->Connect (m_peer);
+			m_socket->SetRecvCallback (MakeNullCallback<void, Ptr<Socket> > ());
+		}
+		if (m_taxa.GetBitRate () > 0) {
+			m_intervalo = Seconds (m_tamanho * 8.0 / m_taxa.GetBitRate ());
+		}
+		// Intervalo nulo agendaria todos os envios no mesmo instante, sem fim
+		NS_ABORT_MSG_IF (!m_intervalo.IsStrictlyPositive (),
+				"CbrSource com intervalo nao positivo: " << m_intervalo.GetSeconds () << " s");
+		m_ativo = true;
+		m_geracao++;
+		m_inicio = Simulator::Now () + m_deslocamento;
+		m_ultimo = Simulator::Now ();
+		m_enviados = 0;
+		Proximo (Instante (0));
+	}
+
+	// Grade nominal início + n * intervalo mais o jitter do pacote. O jitter
+	// não acumula e o envio nunca volta antes do anterior.
+	Time Instante (uint64_t n)
+	{
+		Time quando = m_inicio + TimeStep (m_intervalo.GetTimeStep () * n);
+		double jitter = m_jitter->GetValue ();
+		if (jitter > 0.0) {
+			Time j = Seconds (jitter);
+			quando += j < m_intervalo ? j : m_intervalo - TimeStep (1);
+		}
+		if (quando < m_ultimo) {
+			quando = m_ultimo;
+		}
+		m_ultimo = quando;
+		return quando;
+	}
+
+	virtual void StopApplication (void)
+	{
+		// No modo em lote a entrada pendente é descartada pelo scheduler
+		m_ativo = false;
+		Simulator::Cancel (m_evento);
+		if (m_socket != 0) {
+			m_socket->Close ();
+		}
+	}
+
+	void Proximo (Time quando)
+	{
+		if (m_emLote) {
+			CbrBatchScheduler::Get ()->Agendar (this, quando);
+		} else {
+			m_evento = Simulator::Schedule (quando - Simulator::Now (), &CbrSourceApplication::EnviarSozinho, this);
+		}
+	}
+
+	void EnviarSozinho (void)
+	{
+		Time proximo = Enviar ();
+		if (m_ativo) {
+			Proximo (proximo);
+		}
+	}
+
+	Address m_peer;
+	uint32_t m_tamanho;
+	Time m_intervalo;
+	DataRate m_taxa;
+	Ptr<RandomVariableStream> m_jitter;
+	Time m_deslocamento;
+	uint64_t m_maxPacotes;
+	bool m_emLote;
+
+	Ptr<Socket> m_socket;
+	bool m_ativo;
+	uint32_t m_geracao;
+	Time m_inicio;
+	Time m_ultimo;
+	uint64_t m_enviados;
+	EventId m_evento;
+};
+
+NS_OBJECT_ENSURE_REGISTERED (CbrSourceApplication);
+
+
+inline bool
+CbrBatchScheduler::Pendente::Valido (void) const
+{
+	return app->IsAtivo () && app->GetGeracao () == geracao;
+}
+
+inline void
+CbrBatchScheduler::Agendar (Ptr<CbrSourceApplication> app, Time quando)
+{
+	Pendente p;
+	p.quando = quando;
+	p.ordem = m_ordem++;
+	p.geracao = app->GetGeracao ();
+	p.app = app;
+	m_fila.push (p);
+
+	if (!m_evento.IsRunning () || quando < m_quandoEvento) {
+		Simulator::Cancel (m_evento);
+		m_quandoEvento = quando;
+		m_evento = Simulator::Schedule (quando - Simulator::Now (), &CbrBatchScheduler::Disparar, this);
+	}
+}
+
+inline void
+CbrBatchScheduler::Disparar (void)
+{
+	Time agora = Simulator::Now ();
+	m_lotes++;
+
+	// Reagenda só depois de esvaziar o instante atual, senão uma fonte com
+	// intervalo zero entraria em laço
+	std::vector<Pendente> proximos;
+	while (!m_fila.empty () && m_fila.top ().quando == agora) {
+		Pendente p = m_fila.top ();
+		m_fila.pop ();
+		if (!p.Valido ()) {
+			continue;
+		}
+		Time quando = p.app->Enviar ();
+		m_envios++;
+		if (p.app->IsAtivo ()) {
+			p.quando = quando;
+			proximos.push_back (p);
+		}
+	}
+	for (uint32_t i = 0; i < proximos.size (); i++) {
+		proximos[i].ordem = m_ordem++;
+		m_fila.push (proximos[i]);
+	}
+
+	// Descarta entradas de fontes paradas antes de decidir o próximo evento
+	while (!m_fila.empty () && !m_fila.top ().Valido ()) {
+		m_fila.pop ();
+	}
+	if (!m_fila.empty ()) {
+		m_quandoEvento = m_fila.top ().quando;
+		m_evento = Simulator::Schedule (m_quandoEvento - agora, &CbrBatchScheduler::Disparar, this);
+	}
+}
+
+
+class CbrSourceHelper
+{
+public:
+	CbrSourceHelper (Address remoto)
+	{
+		m_factory.SetTypeId ("ns3::CbrSourceApplication");
+		m_factory.Set ("Remote", AddressValue (remoto));
+	}
+
+	void SetAttribute (std::string name, const AttributeValue &value)
+	{
+		m_factory.Set (name, value);
+	}
+
+	ApplicationContainer Install (Ptr<Node> node) const
+	{
+		Ptr<Application> app = m_factory.Create<Application> ();
+		node->AddApplication (app);
+		return ApplicationContainer (app);
+	}
+
+private:
+	ObjectFactory m_factory;
+};
+
+} // namespace ns3
+
+#endif /* CBR_SOURCE_H */
@@ -0,0 +1,211 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef CONVERGENCE_H
+#define CONVERGENCE_H
+
+// Parada antecipada de rodadas que já chegaram ao regime permanente.
+//
+// Depois do aquecimento (inicio), a cada intervalo o monitor soma os
+// contadores de todos os fluxos do FlowMonitor e fecha um lote: vazão
+// agregada e atraso médio por pacote só daquele intervalo (médias em
+// lotes). Com as últimas "janela" médias de lote, o monitor calcula o IC t
+// de 95% de cada métrica; quando as duas meias larguras ficam abaixo de
+// tolerancia vezes a média da janela, chama Simulator::Stop. O instante da
+// parada é a duração efetiva da rodada.
+//
+// Estimativas acumuladas desde o aquecimento não servem de critério: o
+// passo relativo de uma média acumulada cai como 1/n mesmo sem regime
+// permanente. As médias de lote de intervalos vizinhos são correlacionadas;
+// o intervalo precisa ser longo frente às rajadas do tráfego para o IC
+// valer. Um lote sem pacote recebido esvazia a janela.
+
+#include "ns3/core-module.h"
+#include "ns3/flow-monitor-module.h"
+#include "estatistica.h"
+#include <deque>
+#include <string>
+#include <sstream>
+#include <cmath>
+
+namespace ns3 {
+
+struct OpcoesConvergencia {
+	bool ativo;
+	double inicio;       // aquecimento, s
+	double intervalo;    // entre amostras, s
+	uint32_t janela;     // lotes no IC
+	double tolerancia;   // meia largura do IC relativa à média
+
+	OpcoesConvergencia ()
+		: ativo (false),
+		  inicio (3.0),
+		  intervalo (1.0),
+		  janela (5),
+		  tolerancia (0.02)
+	{
+	}
+
+	void Registrar (CommandLine &cmd)
+	{
+		cmd.AddValue ("convergencia", "Stop each run once throughput and delay are stable", ativo);
+		cmd.AddValue ("convInicio", "Warm-up before the convergence monitor starts, in seconds", inicio);
+		cmd.AddValue ("convIntervalo", "Convergence monitor sampling interval, in seconds", intervalo);
+		cmd.AddValue ("convJanela", "Number of most recent interval batches in the confidence interval", janela);
+		cmd.AddValue ("convTolerancia", "Maximum 95% CI half-width of the batch means, relative to their mean", tolerancia);
+	}
+
+	bool Validar (std::string &erro) const
+	{
+		if (inicio < 0.0) {
+			erro = "convInicio negativo";
+			return false;
+		}
+		if (!(intervalo > 0.0)) {
+			erro = "convIntervalo deve ser positivo";
+			return false;
+		}
+		if (janela < 2) {
+			erro = "convJanela deve ser pelo menos 2";
+			return false;
+		}
+		if (!(tolerancia > 0.0)) {
+			erro = "convTolerancia deve ser positiva";
+			return false;
+		}
+		return true;
+	}
+
+	// Entra na chave do cache: mudar a regra de parada muda o resultado
+	std::string Descrever (void) const
+	{
+		std::ostringstream oss;
+		oss << "convergencia=" << ativo;
+		if (ativo) {
+			oss << "\nconvInicio=" << inicio << "\nconvIntervalo=" << intervalo
+				<< "\nconvJanela=" << janela << "\nconvTolerancia=" << tolerancia;
+		}
+		return oss.str ();
+	}
+};
+
+class ConvergenceMonitor
+{
+public:
+	ConvergenceMonitor (Ptr<FlowMonitor> monitor, const OpcoesConvergencia &o)
+		: m_monitor (monitor),
+		  m_opcoes (o),
+		  m_convergiu (false),
+		  m_rxBytes (0),
+		  m_rxPackets (0),
+		  m_delay (0.0)
+	{
+	}
+
+	void Start (void)
+	{
+		Simulator::Schedule (Seconds (m_opcoes.inicio), &ConvergenceMonitor::Iniciar, this);
+	}
+
+	bool Convergiu (void) const
+	{
+		return m_convergiu;
+	}
+
+private:
+	void Somar (uint64_t &rxBytes, uint64_t &rxPackets, double &delay) const
+	{
+		rxBytes = 0;
+		rxPackets = 0;
+		delay = 0.0;
+		const FlowMonitor::FlowStatsContainer &stats = m_monitor->GetFlowStats ();
+		for (FlowMonitor::FlowStatsContainer::const_iterator i = stats.begin (); i != stats.end (); ++i) {
+			rxBytes += i->second.rxBytes;
+			rxPackets += i->second.rxPackets;
+			delay += i->second.delaySum.GetSeconds ();
+		}
+	}
+
+	void Iniciar (void)
+	{
+		Somar (m_rxBytes, m_rxPackets, m_delay);
+		m_t = Simulator::Now ();
+		Simulator::Schedule (Seconds (m_opcoes.intervalo), &ConvergenceMonitor::Amostrar, this);
+	}
+
+	// Fecha o lote do último intervalo
+	void Amostrar (void)
+	{
+		uint64_t rxBytes, rxPackets;
+		double delay;
+		Somar (rxBytes, rxPackets, delay);
+		double duracao = (Simulator::Now () - m_t).GetSeconds ();
+		uint64_t pacotes = rxPackets - m_rxPackets;
+		if (pacotes > 0) {
+			m_vazao.push_back ((rxBytes - m_rxBytes) * 8.0 / duracao);
+			m_atraso.push_back ((delay - m_delay) / pacotes);
+		} else {
+			m_vazao.clear ();
+			m_atraso.clear ();
+		}
+		m_rxBytes = rxBytes;
+		m_rxPackets = rxPackets;
+		m_delay = delay;
+		m_t = Simulator::Now ();
+		while (m_vazao.size () > m_opcoes.janela) {
+			m_vazao.pop_front ();
+			m_atraso.pop_front ();
+		}
+
+		if (m_vazao.size () >= m_opcoes.janela && Estavel (m_vazao) && Estavel (m_atraso)) {
+			m_convergiu = true;
+			Simulator::Stop ();
+			return;
+		}
+		Simulator::Schedule (Seconds (m_opcoes.intervalo), &ConvergenceMonitor::Amostrar, this);
+	}
+
+	// IC t de 95% das médias de lote, relativo à média
+	bool Estavel (const std::deque<double> &v) const
+	{
+		uint32_t n = v.size ();
+		double media = 0.0;
+		for (uint32_t i = 0; i < n; i++) {
+			media += v[i];
+		}
+		media /= n;
+		double soma = 0.0;
+		for (uint32_t i = 0; i < n; i++) {
+			soma += (v[i] - media) * (v[i] - media);
+		}
+		double dp = std::sqrt (soma / (n - 1));
+		return MeiaLarguraT (dp, n) <= m_opcoes.tolerancia * std::fabs (media);
+	}
+
+	Ptr<FlowMonitor> m_monitor;
+	OpcoesConvergencia m_opcoes;
+	bool m_convergiu;
+	Time m_t;            // início do lote aberto
+	uint64_t m_rxBytes;
+	uint64_t m_rxPackets;
+	double m_delay;
+	std::deque<double> m_vazao;
+	std::deque<double> m_atraso;
+};
+
+} // namespace ns3
+
+#endif /* CONVERGENCE_H */
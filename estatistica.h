@@ -0,0 +1,167 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef ESTATISTICA_H
+#define ESTATISTICA_H
+
+// Intervalos de confiança de 95% para as tabelas do Agregador.
+//
+// IC t: média +- t(0,975; n-1) * dp / sqrt(n), com o dp já impresso.
+// Bootstrap: para as métricas que são razões (bitrates e perda) a tabela
+// mostra a razão das médias, sum(num) / sum(den) nas repetições; cada
+// reamostragem sorteia n repetições com reposição e recalcula essa razão,
+// e o IC é o intervalo de percentis 2,5% a 97,5%. As reamostragens são
+// divididas entre threads; o sorteio da reamostragem b do fluxo j depende
+// só de (semente, j, b), então o resultado não muda com o número de threads.
+
+#include <vector>
+#include <algorithm>
+#include <thread>
+#include <cmath>
+#include <limits>
+#include <stdint.h>
+
+struct OpcoesEstatistica {
+	uint32_t reamostras;
+	uint32_t threads;
+	uint32_t semente;
+
+	OpcoesEstatistica ()
+		: reamostras (1000),
+		  threads (std::thread::hardware_concurrency ()),
+		  semente (1)
+	{
+	}
+
+	template <class Cmd>
+	void Registrar (Cmd &cmd)
+	{
+		cmd.AddValue ("bootstrap", "Bootstrap resamples for the ratio metric CIs (0 = off)", reamostras);
+		cmd.AddValue ("bootstrapThreads", "Threads sharing the bootstrap resamples", threads);
+		cmd.AddValue ("bootstrapSeed", "Seed of the bootstrap resampling", semente);
+	}
+};
+
+// Quantil 0,975 da t de Student: tabela até 30 graus de liberdade, depois a
+// expansão de Cornish-Fisher em torno da normal (erro < 1e-4).
+inline double
+QuantilT975 (uint32_t gl)
+{
+	static const double tabela[30] = {
+		12.706, 4.303, 3.182, 2.776, 2.571, 2.447, 2.365, 2.306, 2.262, 2.228,
+		2.201, 2.179, 2.160, 2.145, 2.131, 2.120, 2.110, 2.101, 2.093, 2.086,
+		2.080, 2.074, 2.069, 2.064, 2.060, 2.056, 2.052, 2.048, 2.045, 2.042
+	};
+	if (gl == 0) {
+		return std::numeric_limits<double>::quiet_NaN ();
+	}
+	if (gl <= 30) {
+		return tabela[gl - 1];
+	}
+	double z = 1.959964, v = gl;
+	double z3 = z * z * z, z5 = z3 * z * z;
+	return z + (z3 + z) / (4 * v) + (5 * z5 + 16 * z3 + 3 * z) / (96 * v * v);
+}
+
+// Meia largura do IC t de 95%
+inline double
+MeiaLarguraT (double dp, uint32_t n)
+{
+	if (n < 2) {
+		return std::numeric_limits<double>::quiet_NaN ();
+	}
+	return QuantilT975 (n - 1) * dp / std::sqrt ((double) n);
+}
+
+// splitmix64: barato de semear, um gerador por reamostragem
+inline uint64_t
+ProximoAleatorio (uint64_t &estado)
+{
+	uint64_t z = (estado += 0x9e3779b97f4a7c15ULL);
+	z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+	z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+	return z ^ (z >> 31);
+}
+
+// num e den: numRazoes razões, cada uma [k][fluxo] (n repetições, numFluxos
+// por repetição). inf e sup: [razão][fluxo]. Reamostragens sem nenhum valor
+// finito (denominador zero) dão NaN.
+inline void
+BootstrapRazoes (const std::vector<const double *> &num, const std::vector<const double *> &den,
+                 uint32_t numFluxos, uint32_t n, const OpcoesEstatistica &o,
+                 std::vector<double> &inf, std::vector<double> &sup)
+{
+	uint32_t numRazoes = num.size ();
+	uint32_t b = o.reamostras;
+	inf.assign (numRazoes * numFluxos, std::numeric_limits<double>::quiet_NaN ());
+	sup.assign (numRazoes * numFluxos, std::numeric_limits<double>::quiet_NaN ());
+	if (b == 0 || n == 0 || numFluxos == 0) {
+		return;
+	}
+
+	// [razão][fluxo][reamostragem]
+	std::vector<double> valores ((size_t) numRazoes * numFluxos * b);
+	uint32_t numThreads = std::max (1u, std::min (o.threads, b));
+
+	std::vector<std::thread> threads;
+	for (uint32_t t = 0; t < numThreads; t++) {
+		threads.push_back (std::thread ([&, t] () {
+			std::vector<uint32_t> idx (n);
+			std::vector<double> sNum (numRazoes), sDen (numRazoes);
+			for (uint32_t r = t; r < b; r += numThreads) {
+				for (uint32_t j = 0; j < numFluxos; j++) {
+					uint64_t estado = ((uint64_t) o.semente << 40) ^ ((uint64_t) j << 20) ^ r;
+					for (uint32_t l = 0; l < n; l++) {
+						idx[l] = ProximoAleatorio (estado) % n;
+					}
+					for (uint32_t q = 0; q < numRazoes; q++) {
+						double a = 0.0, d = 0.0;
+						for (uint32_t l = 0; l < n; l++) {
+							a += num[q][idx[l] * numFluxos + j];
+							d += den[q][idx[l] * numFluxos + j];
+						}
+						valores[((size_t) q * numFluxos + j) * b + r] = a / d;
+					}
+				}
+			}
+		}));
+	}
+	for (uint32_t t = 0; t < threads.size (); t++) {
+		threads[t].join ();
+	}
+
+	std::vector<double> finitos;
+	for (uint32_t q = 0; q < numRazoes; q++) {
+		for (uint32_t j = 0; j < numFluxos; j++) {
+			const double *v = &valores[((size_t) q * numFluxos + j) * b];
+			finitos.clear ();
+			for (uint32_t r = 0; r < b; r++) {
+				if (std::isfinite (v[r])) {
+					finitos.push_back (v[r]);
+				}
+			}
+			if (finitos.empty ()) {
+				continue;
+			}
+			std::sort (finitos.begin (), finitos.end ());
+			uint32_t ultimo = finitos.size () - 1;
+			inf[q * numFluxos + j] = finitos[(uint32_t) std::floor (0.025 * ultimo + 0.5)];
+			sup[q * numFluxos + j] = finitos[(uint32_t) std::floor (0.975 * ultimo + 0.5)];
+		}
+	}
+}
+
+#endif /* ESTATISTICA_H */
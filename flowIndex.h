@@ -0,0 +1,152 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef FLOW_INDEX_H
+#define FLOW_INDEX_H
+
+// Classificação dos fluxos de uma rodada por estação e sentido.
+//
+// Os FlowIds são dados na ordem do primeiro pacote visto, então "FlowId - 1"
+// só coincide com a estação por acaso: com TCP os fluxos de ACK
+// (servidor -> estação) se intercalam com os de dados. O índice é montado
+// uma vez por rodada, logo depois do Simulator::Run, a partir do endereço de
+// cada estação e do Ipv4FlowClassifier::FindFlow; os laços de estatística
+// só consultam um vetor indexado pelo FlowId.
+
+#include "ns3/internet-module.h"
+#include "ns3/flow-monitor-module.h"
+#include "flowRecord.h"
+#include "runResult.h"
+#include <vector>
+#include <unordered_map>
+
+namespace ns3 {
+
+enum DirecaoFluxo {
+	FLUXO_DADOS,   // estação -> servidor
+	FLUXO_ACK      // servidor -> estação (ACKs do TCP)
+};
+
+struct FlowClass {
+	bool valido;
+	uint32_t estacao;
+	DirecaoFluxo direcao;
+	uint16_t porta;    // porta do servidor
+	Ipv4FlowClassifier::FiveTuple tupla;
+};
+
+class FlowIndex
+{
+public:
+	FlowIndex (const Ipv4InterfaceContainer &estacoes)
+		: m_numAck (0)
+	{
+		for (uint32_t i = 0; i < estacoes.GetN (); i++) {
+			m_estacaoPorEndereco[estacoes.GetAddress (i).Get ()] = i;
+		}
+	}
+
+	void Construir (Ptr<Ipv4FlowClassifier> classifier, const FlowMonitor::FlowStatsContainer &stats)
+	{
+		FlowId maior = stats.empty () ? 0 : stats.rbegin ()->first;
+		m_classes.assign (maior + 1, FlowClass ());
+		m_numAck = 0;
+
+		for (FlowMonitor::FlowStatsContainer::const_iterator i = stats.begin (); i != stats.end (); ++i) {
+			FlowClass &c = m_classes[i->first];
+			c.tupla = classifier->FindFlow (i->first);
+			c.valido = false;
+
+			std::unordered_map<uint32_t, uint32_t>::const_iterator origem = m_estacaoPorEndereco.find (c.tupla.sourceAddress.Get ());
+			std::unordered_map<uint32_t, uint32_t>::const_iterator destino = m_estacaoPorEndereco.find (c.tupla.destinationAddress.Get ());
+			if (origem != m_estacaoPorEndereco.end ()) {
+				c.valido = true;
+				c.estacao = origem->second;
+				c.direcao = FLUXO_DADOS;
+				c.porta = c.tupla.destinationPort;
+			} else if (destino != m_estacaoPorEndereco.end ()) {
+				c.valido = true;
+				c.estacao = destino->second;
+				c.direcao = FLUXO_ACK;
+				c.porta = c.tupla.sourcePort;
+				m_numAck++;
+			}
+		}
+	}
+
+	const FlowClass &Get (FlowId id) const
+	{
+		return m_classes[id];
+	}
+
+	uint32_t GetNumAck (void) const
+	{
+		return m_numAck;
+	}
+
+	FlowRecord Registro (FlowId id, const FlowMonitor::FlowStats &s) const
+	{
+		const Ipv4FlowClassifier::FiveTuple &t = m_classes[id].tupla;
+		FlowRecord r;
+		r.flowId = id;
+		r.sourceAddress = t.sourceAddress.Get ();
+		r.destinationAddress = t.destinationAddress.Get ();
+		r.sourcePort = t.sourcePort;
+		r.destinationPort = t.destinationPort;
+		r.protocol = t.protocol;
+		r.timeFirstTxPacket = s.timeFirstTxPacket.GetSeconds ();
+		r.timeFirstRxPacket = s.timeFirstRxPacket.GetSeconds ();
+		r.timeLastTxPacket = s.timeLastTxPacket.GetSeconds ();
+		r.timeLastRxPacket = s.timeLastRxPacket.GetSeconds ();
+		r.delaySum = s.delaySum.GetSeconds ();
+		r.jitterSum = s.jitterSum.GetSeconds ();
+		r.lastDelay = s.lastDelay.GetSeconds ();
+		r.txBytes = s.txBytes;
+		r.rxBytes = s.rxBytes;
+		r.txPackets = s.txPackets;
+		r.rxPackets = s.rxPackets;
+		r.lostPackets = s.lostPackets;
+		return r;
+	}
+
+	// Fluxos válidos da rodada na ordem do FlowId, no formato do cache; a
+	// duração e as flags ficam por conta de quem simulou.
+	ResultadoRodada Resultado (const FlowMonitor::FlowStatsContainer &stats) const
+	{
+		ResultadoRodada resultado;
+		for (FlowMonitor::FlowStatsContainer::const_iterator i = stats.begin (); i != stats.end (); ++i) {
+			const FlowClass &c = m_classes[i->first];
+			if (!c.valido) {
+				continue;
+			}
+			ResultadoFluxo f = ResultadoFluxo ();
+			f.fluxo = Registro (i->first, i->second);
+			f.estacao = c.estacao;
+			f.ack = c.direcao == FLUXO_ACK ? 1 : 0;
+			resultado.fluxos.push_back (f);
+		}
+		return resultado;
+	}
+
+private:
+	std::unordered_map<uint32_t, uint32_t> m_estacaoPorEndereco;
+	std::vector<FlowClass> m_classes;
+	uint32_t m_numAck;
+};
+
+} // namespace ns3
+
+#endif /* FLOW_INDEX_H */
@@ -0,0 +1,235 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "ns3/core-module.h"
+#include "flowRecord.h"
+#include "flowMonXml.h"
+#include "agregacao.h"
+#include <vector>
+#include <map>
+#include <thread>
+#include <atomic>
+#include <algorithm>
+#include <dirent.h>
+#include <cctype>
+
+// Pós-processamento dos XML do FlowMonitor de um cenário.
+//
+// Lê todos os sim/<cenario>/<nWifi>-<k>.xml em paralelo (uma thread por
+// arquivo, no máximo --threads ao mesmo tempo, cada uma com um buffer fixo
+// de leitura) e imprime para cada nWifi a mesma tabela de média/desvio
+// padrão que os programas imprimem no fim do laço z.
+//
+// Varreduras de mais de uma dimensão gravam <nWifi>-<k>-s<packetSize>-r
+// <dataRate>-b<p2pRate>.xml (sweep.h); cada sufixo é um ponto da grade e
+// sai em tabela própria. Arquivos .xml fora desses formatos são listados
+// no stderr e ignorados.
+//
+// Obs:
+// executar comando : ./waf --run "flowMonStats --dir=sim/cbrMobility" > result.txt
+
+
+using namespace ns3;
+using namespace std;
+
+NS_LOG_COMPONENT_DEFINE ("FlowMonStatsProgram");
+
+
+struct Rodada {
+	uint32_t nWifi;
+	uint32_t k;
+	std::string sufixo;   // ponto da grade, vazio na varredura só de nWifi
+	std::string arquivo;
+	FlowMonXmlResultado resultado;
+};
+
+bool porRodada (const Rodada *a, const Rodada *b) {
+	if (a->nWifi != b->nWifi) {
+		return a->nWifi < b->nWifi;
+	}
+	return a->sufixo != b->sufixo ? a->sufixo < b->sufixo : a->k < b->k;
+}
+
+// <nWifi>-<k>[<sufixo>].xml; o sufixo, se houver, é o -s...-r...-b... do MontarGrade
+bool lerNome (const std::string &nome, uint32_t &nWifi, uint32_t &k, std::string &sufixo) {
+	int lido = 0;
+	if (sscanf (nome.c_str (), "%u-%u%n", &nWifi, &k, &lido) != 2 || !isdigit ((unsigned char) nome[0])) {
+		return false;
+	}
+	std::string resto = nome.substr (lido);
+	if (resto.size () < 4 || resto.compare (resto.size () - 4, 4, ".xml") != 0) {
+		return false;
+	}
+	sufixo = resto.substr (0, resto.size () - 4);
+	if (sufixo.empty ()) {
+		return true;
+	}
+	std::string::size_type r = sufixo.find ("-r"), b = sufixo.rfind ("-b");
+	return sufixo.compare (0, 2, "-s") == 0 && r != std::string::npos && b != std::string::npos && r < b;
+}
+
+// -s1426-r1Mbps-b5Mbps -> packetSize=1426 dataRate=1Mbps p2pRate=5Mbps
+std::string rotuloSufixo (const std::string &sufixo) {
+	std::string::size_type r = sufixo.find ("-r"), b = sufixo.rfind ("-b");
+	std::string dataRate = sufixo.substr (r + 2, b - r - 2);
+	return "packetSize=" + sufixo.substr (2, r - 2) + " dataRate=" + (dataRate.empty () ? "padrao" : dataRate)
+		+ " p2pRate=" + sufixo.substr (b + 2);
+}
+
+void imprimirHistograma (std::string nome, uint32_t nWifi, const Histograma &h) {
+	std::cout << nome << " nWifi " << nWifi << "\n";
+	std::cout << "start;";
+	std::cout << "width;";
+	std::cout << "count;";
+	std::cout << "\n";
+	for (Histograma::const_iterator i = h.begin (); i != h.end (); ++i) {
+		std::cout << i->second.start << ";";
+		std::cout << i->second.width << ";";
+		std::cout << i->second.count << ";";
+		std::cout << "\n";
+	}
+	std::cout << "\n";
+}
+
+
+int main (int argc, char *argv[]) {
+	std::string dir = "sim/cbrMobility";
+	uint32_t threads = std::thread::hardware_concurrency ();
+	bool histogramas = false;
+
+	OpcoesEstatistica estatistica;
+
+	CommandLine cmd;
+	cmd.AddValue ("dir", "Directory with the <nWifi>-<k>.xml FlowMonitor dumps", dir);
+	cmd.AddValue ("threads", "Maximum number of files parsed at the same time", threads);
+	cmd.AddValue ("histogramas", "Also print delay/jitter histograms summed per nWifi", histogramas);
+	estatistica.Registrar (cmd);
+	cmd.Parse (argc,argv);
+
+	if (threads == 0) {
+		threads = 1;
+	}
+
+	std::vector<Rodada> rodadas;
+	DIR *d = opendir (dir.c_str ());
+	if (d == 0) {
+		std::cout << "Diretorio nao encontrado: " << dir << std::endl;
+		return 1;
+	}
+	struct dirent *e;
+	while ((e = readdir (d)) != 0) {
+		std::string nome = e->d_name;
+		Rodada r;
+		if (lerNome (nome, r.nWifi, r.k, r.sufixo)) {
+			r.arquivo = dir + "/" + nome;
+			rodadas.push_back (r);
+		} else if (nome.size () > 4 && nome.compare (nome.size () - 4, 4, ".xml") == 0 && nome != "animation.xml") {
+			std::cerr << "Ignorado (nome fora do formato <nWifi>-<k>.xml): " << nome << "\n";
+		}
+	}
+	closedir (d);
+
+	// Cada thread pega o próximo arquivo livre até acabar
+	std::atomic<uint32_t> proximo (0);
+	std::vector<std::thread> trabalhadores;
+	for (uint32_t t = 0; t < threads && t < rodadas.size (); t++) {
+		trabalhadores.push_back (std::thread ([&rodadas, &proximo] () {
+			FlowMonXmlReader leitor;
+			uint32_t i;
+			while ((i = proximo++) < rodadas.size ()) {
+				leitor.Ler (rodadas[i].arquivo, rodadas[i].resultado);
+			}
+		}));
+	}
+	for (uint32_t t = 0; t < trabalhadores.size (); t++) {
+		trabalhadores[t].join ();
+	}
+
+	std::vector<const Rodada *> ordem;
+	for (uint32_t i = 0; i < rodadas.size (); i++) {
+		if (rodadas[i].resultado.ok) {
+			ordem.push_back (&rodadas[i]);
+		} else {
+			std::cerr << "Falha ao ler " << rodadas[i].arquivo << "\n";
+		}
+	}
+	std::sort (ordem.begin (), ordem.end (), porRodada);
+
+	uint32_t i = 0;
+	while (i < ordem.size ()) {
+		uint32_t nWifi = ordem[i]->nWifi;
+		const std::string &sufixo = ordem[i]->sufixo;
+		uint32_t fim = i;
+		while (fim < ordem.size () && ordem[fim]->nWifi == nWifi && ordem[fim]->sufixo == sufixo) {
+			fim++;
+		}
+
+		// Médias sobre as repetições lidas, não sobre o maior k: uma
+		// repetição ausente ou ilegível não entra como zeros na tabela
+		uint32_t repeticao = fim - i;
+		if (ordem[fim - 1]->k != repeticao) {
+			std::cerr << "nWifi " << nWifi << sufixo << ": " << repeticao << " repeticoes lidas, maior k "
+				<< ordem[fim - 1]->k << "\n";
+		}
+
+		// Como nos programas: linha j da tabela é a estação j, dados e ACKs separados
+		Agregador agregadorDados (nWifi, repeticao, estatistica);
+		Agregador agregadorAck (nWifi, repeticao, estatistica);
+		bool temAck = false;
+		Histograma delay, jitter;
+		for (uint32_t r = i; r < fim; r++) {
+			const FlowMonXmlResultado &res = ordem[r]->resultado;
+			for (uint32_t f = 0; f < res.fluxos.size (); f++) {
+				uint32_t estacao;
+				bool ack;
+				if (!ClassificarPorSubrede (res.fluxos[f], estacao, ack)) {
+					continue;
+				}
+				if (ack) {
+					agregadorAck.Adicionar (estacao, r - i + 1, res.fluxos[f]);
+					temAck = true;
+				} else {
+					agregadorDados.Adicionar (estacao, r - i + 1, res.fluxos[f]);
+				}
+			}
+			for (Histograma::const_iterator h = res.delay.begin (); h != res.delay.end (); ++h) {
+				SomarBin (delay, h->first, h->second);
+			}
+			for (Histograma::const_iterator h = res.jitter.begin (); h != res.jitter.end (); ++h) {
+				SomarBin (jitter, h->first, h->second);
+			}
+		}
+
+		if (!sufixo.empty ()) {
+			std::cout << "\n\nPonto da grade: nWifi=" << nWifi << " " << rotuloSufixo (sufixo);
+		}
+		agregadorDados.Acumular ();
+		agregadorDados.Imprimir (std::cout, nWifi);
+		if (temAck) {
+			std::cout << "Fluxos ACK (servidor -> estação)";
+			agregadorAck.Acumular ();
+			agregadorAck.Imprimir (std::cout, nWifi);
+		}
+		if (histogramas) {
+			imprimirHistograma ("delayHistogram", nWifi, delay);
+			imprimirHistograma ("jitterHistogram", nWifi, jitter);
+		}
+
+		i = fim;
+	}
+
+	return 0;
+}
@@ -0,0 +1,252 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef FLOWMON_XML_H
+#define FLOWMON_XML_H
+
+// Leitura em streaming (estilo SAX) dos XML do FlowMonitor::SerializeToXmlFile.
+//
+// O arquivo é lido em blocos de tamanho fixo e cada tag é entregue assim que
+// fecha; nada do documento fica em memória além da tag corrente. Só as
+// partes usadas pela análise são interpretadas: FlowStats/Flow (com os
+// histogramas), Ipv4FlowClassifier/Flow e os bins dos histogramas.
+//
+// Ler só dá o arquivo como lido (res.ok) se não houve erro de leitura e o
+// </FlowMonitor> final apareceu: um XML cortado (rodada interrompida, disco
+// cheio) é recusado em vez de entrar na tabela com fluxos faltando.
+
+#include "flowRecord.h"
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+#include <map>
+#include <stdint.h>
+
+struct HistogramBin {
+	double start;
+	double width;
+	uint64_t count;
+};
+
+// Soma de bins por índice; os bins do FlowMonitor têm largura fixa por
+// histograma, então somar por índice entre fluxos e rodadas é válido.
+typedef std::map<uint32_t, HistogramBin> Histograma;
+
+inline void
+SomarBin (Histograma &h, uint32_t index, const HistogramBin &b)
+{
+	Histograma::iterator it = h.find (index);
+	if (it == h.end ()) {
+		h[index] = b;
+	} else {
+		it->second.count += b.count;
+	}
+}
+
+struct FlowMonXmlResultado {
+	std::vector<FlowRecord> fluxos;   // ordenados por flowId
+	Histograma delay;
+	Histograma jitter;
+	Histograma packetSize;
+	bool ok;
+};
+
+class FlowMonXmlReader
+{
+public:
+	FlowMonXmlReader ()
+		: m_secao (NENHUMA),
+		  m_histograma (0),
+		  m_fechado (false)
+	{
+	}
+
+	bool Ler (const std::string &arquivo, FlowMonXmlResultado &res)
+	{
+		res.ok = false;
+		res.fluxos.clear ();
+		m_res = &res;
+		m_indice.clear ();
+		m_secao = NENHUMA;
+		m_histograma = 0;
+		m_fechado = false;
+
+		FILE *f = fopen (arquivo.c_str (), "rb");
+		if (f == 0) {
+			return false;
+		}
+
+		char bloco[64 * 1024];
+		std::string tag;
+		bool dentro = false;
+		size_t n;
+		while ((n = fread (bloco, 1, sizeof (bloco), f)) > 0) {
+			for (size_t i = 0; i < n; i++) {
+				char c = bloco[i];
+				if (!dentro) {
+					if (c == '<') {
+						dentro = true;
+						tag.clear ();
+					}
+				} else if (c == '>') {
+					dentro = false;
+					Tag (tag);
+				} else {
+					tag += c;
+				}
+			}
+		}
+		bool erro = ferror (f) != 0;
+		fclose (f);
+		if (erro || !m_fechado) {
+			return false;
+		}
+		res.ok = true;
+		return true;
+	}
+
+private:
+	enum Secao { NENHUMA, FLOW_STATS, CLASSIFIER };
+
+	// Valor do atributo nome="..." dentro da tag, ou vazio.
+	static std::string Atributo (const std::string &tag, const char *nome)
+	{
+		std::string chave = std::string (" ") + nome + "=\"";
+		size_t p = tag.find (chave);
+		if (p == std::string::npos) {
+			return "";
+		}
+		p += chave.size ();
+		size_t fim = tag.find ('"', p);
+		return tag.substr (p, fim - p);
+	}
+
+	// Tempos do ns-3 no XML: "+2000000000.0ns" (ou s, ms, us, ps, fs).
+	static double Segundos (const std::string &v)
+	{
+		if (v.empty ()) {
+			return 0.0;
+		}
+		char *fim;
+		double x = strtod (v.c_str (), &fim);
+		if (strncmp (fim, "ns", 2) == 0) return x / 1e9;
+		if (strncmp (fim, "us", 2) == 0) return x / 1e6;
+		if (strncmp (fim, "ms", 2) == 0) return x / 1e3;
+		if (strncmp (fim, "ps", 2) == 0) return x / 1e12;
+		if (strncmp (fim, "fs", 2) == 0) return x / 1e15;
+		return x;
+	}
+
+	static uint64_t Inteiro (const std::string &v)
+	{
+		return strtoull (v.c_str (), 0, 10);
+	}
+
+	FlowRecord &Fluxo (uint32_t id)
+	{
+		std::map<uint32_t, uint32_t>::iterator it = m_indice.find (id);
+		if (it != m_indice.end ()) {
+			return m_res->fluxos[it->second];
+		}
+		// FlowIds saem em ordem crescente nas duas seções
+		m_indice[id] = m_res->fluxos.size ();
+		FlowRecord r = FlowRecordVazio ();
+		r.flowId = id;
+		m_res->fluxos.push_back (r);
+		return m_res->fluxos.back ();
+	}
+
+	static std::string Nome (const std::string &tag)
+	{
+		size_t fim = tag.find_first_of (" \t\r\n/");
+		return tag.substr (0, fim);
+	}
+
+	void Tag (const std::string &tag)
+	{
+		if (tag.empty () || tag[0] == '?' || tag[0] == '!') {
+			return;
+		}
+		if (tag[0] == '/') {
+			std::string nome = tag.substr (1);
+			if (nome == "FlowStats" || nome == "Ipv4FlowClassifier") {
+				m_secao = NENHUMA;
+			} else if (nome == "FlowMonitor") {
+				m_fechado = true;
+			} else if (nome == "delayHistogram" || nome == "jitterHistogram" || nome == "packetSizeHistogram") {
+				m_histograma = 0;
+			}
+			return;
+		}
+
+		std::string nome = Nome (tag);
+		if (nome == "FlowStats") {
+			m_secao = FLOW_STATS;
+		} else if (nome == "Ipv4FlowClassifier") {
+			m_secao = CLASSIFIER;
+		} else if (nome == "Flow" && m_secao == FLOW_STATS) {
+			FlowRecord &r = Fluxo (Inteiro (Atributo (tag, "flowId")));
+			r.timeFirstTxPacket = Segundos (Atributo (tag, "timeFirstTxPacket"));
+			r.timeFirstRxPacket = Segundos (Atributo (tag, "timeFirstRxPacket"));
+			r.timeLastTxPacket = Segundos (Atributo (tag, "timeLastTxPacket"));
+			r.timeLastRxPacket = Segundos (Atributo (tag, "timeLastRxPacket"));
+			r.delaySum = Segundos (Atributo (tag, "delaySum"));
+			r.jitterSum = Segundos (Atributo (tag, "jitterSum"));
+			r.lastDelay = Segundos (Atributo (tag, "lastDelay"));
+			r.txBytes = Inteiro (Atributo (tag, "txBytes"));
+			r.rxBytes = Inteiro (Atributo (tag, "rxBytes"));
+			r.txPackets = Inteiro (Atributo (tag, "txPackets"));
+			r.rxPackets = Inteiro (Atributo (tag, "rxPackets"));
+			r.lostPackets = Inteiro (Atributo (tag, "lostPackets"));
+		} else if (nome == "Flow" && m_secao == CLASSIFIER) {
+			FlowRecord &r = Fluxo (Inteiro (Atributo (tag, "flowId")));
+			r.sourceAddress = EnderecoDeStr (Atributo (tag, "sourceAddress"));
+			r.destinationAddress = EnderecoDeStr (Atributo (tag, "destinationAddress"));
+			r.protocol = Inteiro (Atributo (tag, "protocol"));
+			r.sourcePort = Inteiro (Atributo (tag, "sourcePort"));
+			r.destinationPort = Inteiro (Atributo (tag, "destinationPort"));
+		} else if (nome == "delayHistogram") {
+			m_histograma = &m_res->delay;
+		} else if (nome == "jitterHistogram") {
+			m_histograma = &m_res->jitter;
+		} else if (nome == "packetSizeHistogram") {
+			m_histograma = &m_res->packetSize;
+		} else if (nome == "bin" && m_histograma != 0) {
+			HistogramBin b;
+			b.start = strtod (Atributo (tag, "start").c_str (), 0);
+			b.width = strtod (Atributo (tag, "width").c_str (), 0);
+			b.count = Inteiro (Atributo (tag, "count"));
+			SomarBin (*m_histograma, Inteiro (Atributo (tag, "index")), b);
+		}
+
+		// Histograma vazio fecha na própria tag: <delayHistogram nBins="0" />
+		if (!tag.empty () && tag[tag.size () - 1] == '/' && nome != "bin") {
+			if (nome == "delayHistogram" || nome == "jitterHistogram" || nome == "packetSizeHistogram") {
+				m_histograma = 0;
+			}
+		}
+	}
+
+	Secao m_secao;
+	Histograma *m_histograma;
+	bool m_fechado;   // </FlowMonitor> visto
+	FlowMonXmlResultado *m_res;
+	std::map<uint32_t, uint32_t> m_indice;
+};
+
+#endif /* FLOWMON_XML_H */
@@ -0,0 +1,98 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef FLOW_RECORD_H
+#define FLOW_RECORD_H
+
+// Registro de um fluxo de uma rodada: o FlowMonitor::FlowStats (tempos em
+// segundos) mais a 5-tupla do Ipv4FlowClassifier. Não depende do ns-3 para
+// poder ser usado também pelas ferramentas que leem os XML e caches.
+
+#include <string>
+#include <sstream>
+#include <stdint.h>
+
+struct FlowRecord {
+	uint32_t flowId;
+	uint32_t sourceAddress;      // ordem do host, como Ipv4Address::Get ()
+	uint32_t destinationAddress;
+	uint16_t sourcePort;
+	uint16_t destinationPort;
+	uint8_t protocol;
+
+	double timeFirstTxPacket;
+	double timeFirstRxPacket;
+	double timeLastTxPacket;
+	double timeLastRxPacket;
+	double delaySum;
+	double jitterSum;
+	double lastDelay;
+
+	uint64_t txBytes;
+	uint64_t rxBytes;
+	uint64_t txPackets;
+	uint64_t rxPackets;
+	uint64_t lostPackets;
+};
+
+inline FlowRecord
+FlowRecordVazio (void)
+{
+	FlowRecord r = { 0, 0, 0, 0, 0, 0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0, 0, 0, 0, 0 };
+	return r;
+}
+
+// Mesmo formato do operator<< do Ipv4Address.
+inline std::string
+EnderecoStr (uint32_t a)
+{
+	std::ostringstream oss;
+	oss << ((a >> 24) & 0xff) << "." << ((a >> 16) & 0xff) << "." << ((a >> 8) & 0xff) << "." << (a & 0xff);
+	return oss.str ();
+}
+
+inline uint32_t
+EnderecoDeStr (const std::string &s)
+{
+	uint32_t b[4] = { 0, 0, 0, 0 };
+	std::istringstream iss (s);
+	char ponto;
+	iss >> b[0] >> ponto >> b[1] >> ponto >> b[2] >> ponto >> b[3];
+	return (b[0] << 24) | (b[1] << 16) | (b[2] << 8) | b[3];
+}
+
+// Classificação sem os Ipv4InterfaceContainer da rodada (ferramentas que leem
+// os XML): as estações são a subrede wifi 192.168.0.0/24 a partir do .2, o
+// .1 é o AP. Fluxo saindo de uma estação é de dados, chegando é de ACK.
+inline bool
+ClassificarPorSubrede (const FlowRecord &r, uint32_t &estacao, bool &ack)
+{
+	const uint32_t rede = (192u << 24) | (168u << 16);
+	const uint32_t mascara = 0xffffff00;
+	if ((r.sourceAddress & mascara) == rede && (r.sourceAddress & 0xff) >= 2) {
+		estacao = (r.sourceAddress & 0xff) - 2;
+		ack = false;
+		return true;
+	}
+	if ((r.destinationAddress & mascara) == rede && (r.destinationAddress & 0xff) >= 2) {
+		estacao = (r.destinationAddress & 0xff) - 2;
+		ack = true;
+		return true;
+	}
+	return false;
+}
+
+#endif /* FLOW_RECORD_H */
@@ -0,0 +1,108 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef MEMORY_MODEL_H
+#define MEMORY_MODEL_H
+
+// Modelo do pico de memória (RSS) de uma rodada em função de nWifi, usado
+// pelo sweepRunner para admitir workers dentro de --memBudget.
+//
+// Cada worker que termina entra com o pico de RSS que ele mesmo mediu. Com um
+// só nWifi medido a previsão é proporcional a nWifi (nunca menos que o
+// medido), o que superestima os maiores porque ignora a parte fixa. Com
+// dois ou mais, a inclinação sai de mínimos quadrados e o intercepto é
+// subido até a reta ficar acima de todas as medidas: a previsão é um
+// envelope, não uma média.
+
+#include <vector>
+#include <algorithm>
+#include <stdint.h>
+
+class ModeloMemoria
+{
+public:
+	ModeloMemoria ()
+		: m_valido (false),
+		  m_a (0.0),
+		  m_b (0.0),
+		  m_piso (0.0)
+	{
+	}
+
+	void Adicionar (uint32_t nWifi, double mib)
+	{
+		m_n.push_back (nWifi);
+		m_mib.push_back (mib);
+		m_valido = false;
+	}
+
+	bool Calibrado (void) const
+	{
+		return !m_n.empty ();
+	}
+
+	// MiB previstos para uma rodada com nWifi estações
+	double Prever (uint32_t nWifi) const
+	{
+		if (!m_valido) {
+			Ajustar ();
+		}
+		return std::max (m_piso, m_a + m_b * nWifi);
+	}
+
+private:
+	void Ajustar (void) const
+	{
+		uint32_t k = m_n.size ();
+		double mx = 0.0, my = 0.0;
+		for (uint32_t i = 0; i < k; i++) {
+			mx += m_n[i];
+			my += m_mib[i];
+		}
+		mx /= k;
+		my /= k;
+		double sxx = 0.0, sxy = 0.0;
+		for (uint32_t i = 0; i < k; i++) {
+			sxx += (m_n[i] - mx) * (m_n[i] - mx);
+			sxy += (m_n[i] - mx) * (m_mib[i] - my);
+		}
+
+		m_piso = 0.0;
+		if (sxx > 0.0) {
+			m_b = std::max (0.0, sxy / sxx);
+			m_a = m_mib[0] - m_b * m_n[0];
+			for (uint32_t i = 1; i < k; i++) {
+				m_a = std::max (m_a, m_mib[i] - m_b * m_n[i]);
+			}
+		} else {
+			// Um nWifi só: proporcional, pelo maior pico medido
+			double pico = *std::max_element (m_mib.begin (), m_mib.end ());
+			m_b = m_n[0] > 0 ? pico / m_n[0] : 0.0;
+			m_a = 0.0;
+			m_piso = pico;
+		}
+		m_valido = true;
+	}
+
+	std::vector<uint32_t> m_n;
+	std::vector<double> m_mib;
+	mutable bool m_valido;
+	mutable double m_a;
+	mutable double m_b;
+	mutable double m_piso;
+};
+
+#endif /* MEMORY_MODEL_H */
@@ -0,0 +1,239 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef METRIC_KERNELS_H
+#define METRIC_KERNELS_H
+
+// Tabela de métricas em estrutura de arrays para a agregação por nWifi.
+//
+// Cada série (os 12 campos do FlowStats e as 7 métricas derivadas) guarda,
+// para cada repetição k, um array contíguo com um valor por fluxo: os laços
+// internos andam sobre os fluxos, sem desvio nem chamada, e o compilador
+// vetoriza as divisões e somas (-O2 -ftree-vectorize / -O3).
+//
+// Acumular faz uma única passada pelas repetições: calcula as derivadas da
+// repetição e soma, para todas as séries, o valor, o desvio em relação ao
+// primeiro valor válido (a repetição 1, nos campos) e o quadrado desse
+// desvio. Com isso a média sai na mesma ordem
+// de soma de antes e o desvio padrão pode ser calculado em torno de
+// qualquer centro (a média do campo ou a razão das médias, como nos
+// "cálculos importantes") sem segunda passada e sem o cancelamento de
+// soma de quadrados crua quando o valor quase não varia.
+//
+// Derivadas com denominador nulo (fluxo que não recebeu nada, um pacote só,
+// intervalo de tempo zero) não viram inf/NaN: Derivar devolve junto uma
+// máscara 0/1 de validade, o valor inválido fica 0 e as somas de cada série
+// são ponderadas pela máscara, com a contagem de repetições válidas ao lado.
+// Tudo por seleção e multiplicação, sem desvio por campo no laço.
+
+#include <vector>
+#include <cmath>
+#include <limits>
+#include <stdint.h>
+
+class TabelaMetricas
+{
+public:
+	enum Serie {
+		FIRST_TX, FIRST_RX, LAST_TX, LAST_RX, DELAY, JITTER, LAST_DELAY,
+		TX_BYTES, RX_BYTES, TX_PACKETS, RX_PACKETS, LOST_PACKETS,
+		// derivadas, na ordem do cabeçalho dos "cálculos importantes"
+		MEAN_DELAY, MEAN_JITTER, TX_PACKET_SIZE, RX_PACKET_SIZE, TX_BITRATE, RX_BITRATE, LOSS_RATIO,
+		NUM_SERIES
+	};
+	static const uint32_t NUM_CAMPOS = MEAN_DELAY;
+	static const uint32_t NUM_DERIVADAS = NUM_SERIES - NUM_CAMPOS;
+
+	TabelaMetricas (uint32_t numNos, uint32_t repeticao)
+		: m_n (numNos),
+		  m_repeticao (repeticao),
+		  m_dados (NUM_SERIES * repeticao * numNos, 0.0),
+		  m_soma (NUM_SERIES * numNos, 0.0),
+		  m_desl (NUM_SERIES * numNos, 0.0),
+		  m_quad (NUM_SERIES * numNos, 0.0),
+		  m_ref (NUM_SERIES * numNos, 0.0),
+		  m_cont (NUM_SERIES * numNos, 0.0),
+		  m_mediaDerivada (NUM_DERIVADAS * numNos, 0.0),
+		  m_mediaValida (NUM_DERIVADAS * numNos, 0.0),
+		  m_semRecepcao (repeticao, 0)
+	{
+	}
+
+	// Valores da série s na repetição k (0..repeticao-1), um por fluxo
+	double *Valores (uint32_t s, uint32_t k)
+	{
+		return &m_dados[(s * m_repeticao + k) * m_n];
+	}
+
+	const double *Valores (uint32_t s, uint32_t k) const
+	{
+		return &m_dados[(s * m_repeticao + k) * m_n];
+	}
+
+	void Acumular (void)
+	{
+		for (uint32_t s = 0; s < NUM_SERIES * m_n; s++) {
+			m_soma[s] = 0.0;
+			m_desl[s] = 0.0;
+			m_quad[s] = 0.0;
+			m_ref[s] = 0.0;
+			m_cont[s] = 0.0;
+		}
+		// Campos brutos são sempre válidos
+		std::vector<double> uns (m_n, 1.0);
+		std::vector<double> mascara (NUM_DERIVADAS * m_n);
+		const double *campo[NUM_CAMPOS];
+		double *derivada[NUM_DERIVADAS];
+		double *valida[NUM_DERIVADAS];
+		for (uint32_t d = 0; d < NUM_DERIVADAS; d++) {
+			valida[d] = &mascara[d * m_n];
+		}
+		for (uint32_t k = 0; k < m_repeticao; k++) {
+			for (uint32_t c = 0; c < NUM_CAMPOS; c++) {
+				campo[c] = Valores (c, k);
+			}
+			for (uint32_t d = 0; d < NUM_DERIVADAS; d++) {
+				derivada[d] = Valores (NUM_CAMPOS + d, k);
+			}
+			Derivar (campo, derivada, valida, m_n);
+
+			uint32_t semRecepcao = 0;
+			for (uint32_t j = 0; j < m_n; j++) {
+				semRecepcao += campo[RX_PACKETS][j] == 0.0;
+			}
+			m_semRecepcao[k] = semRecepcao;
+
+			// O centro do desvio é o primeiro valor válido da série
+			for (uint32_t s = 0; s < NUM_SERIES; s++) {
+				const double *x = Valores (s, k);
+				const double *ok = s < NUM_CAMPOS ? &uns[0] : valida[s - NUM_CAMPOS];
+				double *soma = &m_soma[s * m_n];
+				double *desl = &m_desl[s * m_n];
+				double *quad = &m_quad[s * m_n];
+				double *ref = &m_ref[s * m_n];
+				double *cont = &m_cont[s * m_n];
+				for (uint32_t j = 0; j < m_n; j++) {
+					ref[j] = (cont[j] == 0.0 && ok[j] != 0.0) ? x[j] : ref[j];
+					double d = ok[j] * (x[j] - ref[j]);
+					soma[j] += ok[j] * x[j];
+					desl[j] += d;
+					quad[j] += d * d;
+					cont[j] += ok[j];
+				}
+			}
+		}
+
+		// Derivadas das médias dos campos ("razão das médias")
+		std::vector<double> medias (NUM_CAMPOS * m_n);
+		for (uint32_t c = 0; c < NUM_CAMPOS; c++) {
+			for (uint32_t j = 0; j < m_n; j++) {
+				medias[c * m_n + j] = m_soma[c * m_n + j] / m_repeticao;
+			}
+			campo[c] = &medias[c * m_n];
+		}
+		for (uint32_t d = 0; d < NUM_DERIVADAS; d++) {
+			derivada[d] = &m_mediaDerivada[d * m_n];
+			valida[d] = &m_mediaValida[d * m_n];
+		}
+		Derivar (campo, derivada, valida, m_n);
+	}
+
+	// Média das repetições do fluxo j
+	double Media (uint32_t s, uint32_t j) const
+	{
+		return m_soma[s * m_n + j] / m_repeticao;
+	}
+
+	// Derivada calculada sobre as médias dos campos do fluxo j; NaN se o
+	// denominador médio for nulo (o fluxo nunca teve a métrica definida)
+	double MediaDerivada (uint32_t s, uint32_t j) const
+	{
+		uint32_t i = (s - NUM_CAMPOS) * m_n + j;
+		return m_mediaValida[i] != 0.0 ? m_mediaDerivada[i] : std::numeric_limits<double>::quiet_NaN ();
+	}
+
+	bool MediaValida (uint32_t s, uint32_t j) const
+	{
+		return m_mediaValida[(s - NUM_CAMPOS) * m_n + j] != 0.0;
+	}
+
+	// Repetições em que a série s do fluxo j foi válida
+	uint32_t Validas (uint32_t s, uint32_t j) const
+	{
+		return m_cont[s * m_n + j];
+	}
+
+	// Fluxos com rxPackets zero na repetição k (0..repeticao-1)
+	uint32_t SemRecepcao (uint32_t k) const
+	{
+		return m_semRecepcao[k];
+	}
+
+	// Desvio padrão amostral das repetições válidas em torno de centro:
+	// sum((x - centro)^2) / (n - 1)
+	double DesvioPadrao (uint32_t s, uint32_t j, double centro) const
+	{
+		double n = m_cont[s * m_n + j];
+		if (n < 2.0) {
+			return std::numeric_limits<double>::quiet_NaN ();
+		}
+		double e = centro - m_ref[s * m_n + j];
+		double q = m_quad[s * m_n + j] - 2.0 * e * m_desl[s * m_n + j] + n * e * e;
+		if (q < 0.0) {
+			q = 0.0;
+		}
+		return std::sqrt (q / (n - 1));
+	}
+
+	// Os sete "cálculos importantes" para n fluxos de uma vez, com a máscara
+	// de validade (1 ou 0) de cada um.
+	static void Derivar (const double *const *campo, double *const *derivada, double *const *valida, uint32_t n)
+	{
+		for (uint32_t j = 0; j < n; j++) {
+			double rxPackets = campo[RX_PACKETS][j];
+			Razao (campo[DELAY][j], rxPackets, derivada[MEAN_DELAY - NUM_CAMPOS][j], valida[MEAN_DELAY - NUM_CAMPOS][j]);
+			Razao (campo[JITTER][j], rxPackets - 1, derivada[MEAN_JITTER - NUM_CAMPOS][j], valida[MEAN_JITTER - NUM_CAMPOS][j]);
+			Razao (campo[TX_BYTES][j], campo[TX_PACKETS][j], derivada[TX_PACKET_SIZE - NUM_CAMPOS][j], valida[TX_PACKET_SIZE - NUM_CAMPOS][j]);
+			Razao (campo[RX_BYTES][j], rxPackets, derivada[RX_PACKET_SIZE - NUM_CAMPOS][j], valida[RX_PACKET_SIZE - NUM_CAMPOS][j]);
+			Razao (8 * campo[TX_BYTES][j], campo[LAST_TX][j] - campo[FIRST_TX][j], derivada[TX_BITRATE - NUM_CAMPOS][j], valida[TX_BITRATE - NUM_CAMPOS][j]);
+			Razao (8 * campo[RX_BYTES][j], campo[LAST_RX][j] - campo[FIRST_RX][j], derivada[RX_BITRATE - NUM_CAMPOS][j], valida[RX_BITRATE - NUM_CAMPOS][j]);
+			Razao (campo[LOST_PACKETS][j], rxPackets + campo[LOST_PACKETS][j], derivada[LOSS_RATIO - NUM_CAMPOS][j], valida[LOSS_RATIO - NUM_CAMPOS][j]);
+		}
+	}
+
+private:
+	// num / den se den > 0, senão 0 com validade 0; selects em vez de desvio
+	static inline void Razao (double num, double den, double &valor, double &valida)
+	{
+		double ok = den > 0.0;
+		valor = ok * (num / (den > 0.0 ? den : 1.0));
+		valida = ok;
+	}
+
+	uint32_t m_n;
+	uint32_t m_repeticao;
+	std::vector<double> m_dados;   // [série][k][fluxo]
+	std::vector<double> m_soma;    // [série][fluxo]
+	std::vector<double> m_desl;    // soma de x - ref
+	std::vector<double> m_quad;    // soma de (x - ref)^2
+	std::vector<double> m_ref;     // primeiro valor válido
+	std::vector<double> m_cont;    // repetições válidas
+	std::vector<double> m_mediaDerivada;
+	std::vector<double> m_mediaValida;
+	std::vector<uint32_t> m_semRecepcao;   // [k]
+};
+
+#endif /* METRIC_KERNELS_H */
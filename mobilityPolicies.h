@@ -0,0 +1,50 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef MOBILITY_POLICIES_H
+#define MOBILITY_POLICIES_H
+
+// Políticas de mobilidade das estações do Cenario (scenario.h). O
+// alocador de posições (grade a partir de (10, 2)) já vem configurado no
+// MobilityHelper; a política escolhe só o modelo.
+
+#include "ns3/core-module.h"
+#include "ns3/network-module.h"
+#include "ns3/mobility-module.h"
+
+namespace ns3 {
+
+struct MobilidadeFixa {
+	static void Instalar (MobilityHelper &mobility, const NodeContainer &estacoes)
+	{
+		mobility.SetMobilityModel ("ns3::ConstantPositionMobilityModel");
+		mobility.Install (estacoes);
+	}
+};
+
+struct MobilidadeRandomWalk {
+	static void Instalar (MobilityHelper &mobility, const NodeContainer &estacoes)
+	{
+		mobility.SetMobilityModel ("ns3::RandomWalk2dMobilityModel",
+				"Bounds", RectangleValue (Rectangle (0, 40, 0, 40))
+		);
+		mobility.Install (estacoes);
+	}
+};
+
+} // namespace ns3
+
+#endif /* MOBILITY_POLICIES_H */
@@ -0,0 +1,456 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef PACKET_POOL_H
+#define PACKET_POOL_H
+
+// Pool de memória por classes de tamanho para o caminho de dados.
+//
+// Packet, Buffer::Data, PacketMetadata, tags e cabeçalhos são alocados pelo
+// ns-3 com new/delete; não há ponto de extensão para trocar o alocador
+// deles sem alterar o src/. O operator new/delete global do programa é
+// substituído em packetPoolNew.h, que só os programas que querem o pool
+// incluem (uma vez, num .cc): nos outros este arquivo só declara a API,
+// Instalado () é falso e new/delete são os da biblioteca. Com a
+// substituição, blocos pequenos (até 4 KiB) vêm de listas livres por
+// classe, o resto vai direto para o malloc.
+//
+// Os blocos não têm cabeçalho. Os slabs são cortados de uma única região de
+// endereços reservada no Enable (true); o delete reconhece um bloco do pool
+// pelo endereço e acha a classe na tabela por slab. Fora da região é
+// ponteiro do malloc e vai para o free sem mais nada: com o pool desligado
+// new/delete custam o mesmo que os da biblioteca e cada bloco o mesmo
+// espaço.
+//
+// Cada thread tem as suas listas livres, sem trava: a thread da simulação
+// não disputa o pool com as threads do bootstrap ou da captura. Só a
+// reposição (um slab de blocos por vez), o excesso de blocos devolvidos a
+// uma thread e as listas de uma thread que termina passam pelas listas
+// globais, com trava.
+//
+// Slabs nunca voltam para o sistema: o pool reduz o custo de cada
+// alocação, não o pico de RSS, que fica no máximo de blocos vivos por classe.
+//
+// Uso: incluir packetPoolNew.h no programa e chamar PacketPool::Enable
+// (true) antes de montar a topologia. Enquanto desabilitado, tudo passa
+// pelo malloc.
+
+#include <cstdlib>
+#include <cstddef>
+#include <new>
+#include <atomic>
+#include <stdint.h>
+#include <iostream>
+#include <sys/mman.h>
+
+namespace PacketPool {
+
+// Região reservada para os slabs (só endereços; as páginas entram no RSS
+// quando um slab é usado). Esgotada, as alocações vão para o malloc.
+static const size_t kSlab = 64 * 1024;
+static const size_t kRegiao = (size_t) 4 << 30;
+static const size_t kNumSlabs = kRegiao / kSlab;
+
+// Classes: 32..512 de 32 em 32 bytes, depois 768, 1024, 1536, 2048, 3072, 4096.
+// Todas múltiplas de 32, então os blocos mantêm o alinhamento do malloc.
+// Um pacote CBR de 450 bytes com cabeçalhos UDP/IP/LLC/MAC cai em 576.
+static const uint32_t kNumClasses = 16 + 6;
+static const size_t kMaxPool = 4096;
+
+struct Bloco {
+	Bloco *proximo;
+};
+
+struct Estatisticas {
+	uint64_t hits;       // servidos de uma lista livre da thread
+	uint64_t misses;     // precisaram de reposição ou foram para o malloc
+	uint64_t emUso;      // bytes em blocos do pool entregues ao programa
+	uint64_t picoEmUso;  // high-water mark de emUso
+	uint64_t slabBytes;  // memória total em slabs do pool (todas as threads)
+};
+
+// Listas de todas as threads; só com a trava
+struct Estado {
+	std::atomic_flag trava;
+	bool habilitado;
+	bool instalado;      // packetPoolNew.h incluído no programa
+	Bloco *livres[kNumClasses];
+	uint64_t slabBytes;  // também o deslocamento do próximo slab na região
+	uint8_t classeSlab[kNumSlabs];
+};
+
+// Listas e contadores de uma thread. emUso é com sinal: um bloco alocado
+// numa thread pode ser liberado em outra.
+struct Cache {
+	Bloco *livres[kNumClasses];
+	uint32_t quantos[kNumClasses];
+	uint64_t hits;
+	uint64_t misses;
+	int64_t emUso;
+	int64_t picoEmUso;
+	bool registrado;     // devolução na saída da thread já agendada
+	bool encerrado;      // thread saindo: só as listas globais
+};
+
+inline Estado &
+GetEstado (void)
+{
+	// POD estático, zerado antes de qualquer construtor global: o operator new
+	// pode ser chamado antes do main.
+	static Estado estado = { ATOMIC_FLAG_INIT, false, false, { 0 }, 0, { 0 } };
+	return estado;
+}
+
+// Início da região dos slabs; nulo até o primeiro Enable (true)
+inline std::atomic<char *> &
+GetRegiao (void)
+{
+	static std::atomic<char *> regiao (0);
+	return regiao;
+}
+
+inline Cache &
+GetCache (void)
+{
+	// POD, inicialização constante: nenhuma guarda nem alocação no acesso
+	static thread_local Cache cache;
+	return cache;
+}
+
+inline size_t
+TamanhoClasse (uint32_t c)
+{
+	static const size_t grandes[] = { 768, 1024, 1536, 2048, 3072, 4096 };
+	return c < 16 ? (c + 1) * 32 : grandes[c - 16];
+}
+
+inline uint32_t
+Classe (size_t n)
+{
+	if (n <= 512)
+	{
+		return n == 0 ? 0 : (uint32_t)((n - 1) / 32);
+	}
+	uint32_t c = 16;
+	while (TamanhoClasse (c) < n)
+	{
+		c++;
+	}
+	return c;
+}
+
+inline uint32_t
+BlocosPorSlab (uint32_t c)
+{
+	return kSlab / TamanhoClasse (c);
+}
+
+inline void
+Travar (Estado &e)
+{
+	while (e.trava.test_and_set (std::memory_order_acquire))
+	{
+	}
+}
+
+inline void
+Destravar (Estado &e)
+{
+	e.trava.clear (std::memory_order_release);
+}
+
+// new (0) precisa de um ponteiro único
+inline void *
+DoMalloc (size_t n)
+{
+	return std::malloc (n == 0 ? 1 : n);
+}
+
+// Passa até n blocos da classe c de uma lista para outra
+inline uint32_t
+Mover (Bloco *&de, Bloco *&para, uint32_t n)
+{
+	uint32_t movidos = 0;
+	while (movidos < n && de != 0)
+	{
+		Bloco *b = de;
+		de = b->proximo;
+		b->proximo = para;
+		para = b;
+		movidos++;
+	}
+	return movidos;
+}
+
+// Devolve as listas da thread às globais; chamado na saída da thread
+inline void
+DevolverTudo (Cache &t)
+{
+	Estado &e = GetEstado ();
+	Travar (e);
+	for (uint32_t c = 0; c < kNumClasses; c++)
+	{
+		Mover (t.livres[c], e.livres[c], t.quantos[c]);
+		t.quantos[c] = 0;
+	}
+	Destravar (e);
+}
+
+struct Devolucao {
+	~Devolucao ()
+	{
+		Cache &t = GetCache ();
+		t.encerrado = true;
+		DevolverTudo (t);
+	}
+};
+
+// Agenda DevolverTudo para a saída da thread (thread_local com destrutor)
+inline void
+RegistrarSaida (void)
+{
+	static thread_local Devolucao devolucao;
+	(void) devolucao;
+}
+
+// Um slab de blocos da classe c para a lista da thread: primeiro das listas
+// globais, senão de um slab novo da região. Falso com a região esgotada.
+inline bool
+Repor (Cache &t, uint32_t c)
+{
+	Estado &e = GetEstado ();
+	uint32_t lote = BlocosPorSlab (c);
+	Travar (e);
+	t.quantos[c] += Mover (e.livres[c], t.livres[c], lote);
+	if (t.livres[c] == 0)
+	{
+		if (e.slabBytes + kSlab > kRegiao)
+		{
+			Destravar (e);
+			return false;
+		}
+		char *slab = GetRegiao ().load (std::memory_order_relaxed) + e.slabBytes;
+		e.classeSlab[e.slabBytes / kSlab] = (uint8_t) c;
+		e.slabBytes += kSlab;
+		size_t passo = TamanhoClasse (c);
+		for (size_t off = 0; off + passo <= kSlab; off += passo)
+		{
+			Bloco *b = (Bloco *) (slab + off);
+			b->proximo = t.livres[c];
+			t.livres[c] = b;
+			t.quantos[c]++;
+		}
+	}
+	Destravar (e);
+	return true;
+}
+
+// Thread já encerrada: direto das listas globais
+inline Bloco *
+AlocarGlobal (uint32_t c)
+{
+	Cache t = Cache ();
+	if (!Repor (t, c))
+	{
+		return 0;
+	}
+	Bloco *b = t.livres[c];
+	t.livres[c] = b->proximo;
+	t.quantos[c]--;
+	DevolverTudo (t);
+	return b;
+}
+
+inline void *
+Alocar (size_t n)
+{
+	Estado &e = GetEstado ();
+	if (!e.habilitado || n > kMaxPool)
+	{
+		if (e.habilitado)
+		{
+			GetCache ().misses++;
+		}
+		return DoMalloc (n);
+	}
+
+	uint32_t c = Classe (n);
+	Cache &t = GetCache ();
+	Bloco *b;
+	if (t.encerrado)
+	{
+		b = AlocarGlobal (c);
+		if (b == 0)
+		{
+			return DoMalloc (n);
+		}
+	}
+	else
+	{
+		if (!t.registrado)
+		{
+			t.registrado = true;
+			RegistrarSaida ();
+		}
+		if (t.livres[c] != 0)
+		{
+			t.hits++;
+		}
+		else
+		{
+			t.misses++;
+			if (!Repor (t, c))
+			{
+				return DoMalloc (n);
+			}
+		}
+		b = t.livres[c];
+		t.livres[c] = b->proximo;
+		t.quantos[c]--;
+		t.emUso += TamanhoClasse (c);
+		if (t.emUso > t.picoEmUso)
+		{
+			t.picoEmUso = t.emUso;
+		}
+	}
+
+	return b;
+}
+
+inline void
+Liberar (void *p)
+{
+	if (p == 0)
+	{
+		return;
+	}
+	// Quem recebeu um bloco do pool já vê a região: ela é publicada antes
+	char *regiao = GetRegiao ().load (std::memory_order_acquire);
+	uintptr_t off = (uintptr_t) p - (uintptr_t) regiao;
+	if (regiao == 0 || off >= kRegiao)
+	{
+		std::free (p);
+		return;
+	}
+	// Blocos do pool voltam para a lista mesmo depois de Enable (false)
+	Estado &e = GetEstado ();
+	uint32_t c = e.classeSlab[off / kSlab];
+	Bloco *b = (Bloco *) p;
+	Cache &t = GetCache ();
+	if (t.encerrado)
+	{
+		Travar (e);
+		b->proximo = e.livres[c];
+		e.livres[c] = b;
+		Destravar (e);
+		return;
+	}
+	b->proximo = t.livres[c];
+	t.livres[c] = b;
+	t.quantos[c]++;
+	t.emUso -= TamanhoClasse (c);
+
+	// Thread que só libera (blocos alocados em outra) não acumula sem limite
+	uint32_t lote = BlocosPorSlab (c);
+	if (t.quantos[c] > 2 * lote)
+	{
+		Travar (e);
+		t.quantos[c] -= Mover (t.livres[c], e.livres[c], lote);
+		Destravar (e);
+	}
+}
+
+// Reserva a região na primeira vez; sem ela o pool fica desligado
+inline void
+Enable (bool habilitar)
+{
+	Estado &e = GetEstado ();
+	if (habilitar && GetRegiao ().load (std::memory_order_relaxed) == 0)
+	{
+		void *r = mmap (0, kRegiao, PROT_READ | PROT_WRITE,
+		                MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+		if (r == MAP_FAILED)
+		{
+			std::cerr << "pool;regiao indisponivel\n";
+			habilitar = false;
+		}
+		else
+		{
+			GetRegiao ().store ((char *) r, std::memory_order_release);
+		}
+	}
+	e.habilitado = habilitar;
+}
+
+inline bool
+IsEnabled (void)
+{
+	return GetEstado ().habilitado;
+}
+
+// Verdadeiro só nos programas que incluem packetPoolNew.h
+inline bool
+Instalado (void)
+{
+	return GetEstado ().instalado;
+}
+
+// Zera os contadores da thread que chama (a da simulação) no início de cada
+// rodada; o pico recomeça do uso atual.
+inline void
+ResetStats (void)
+{
+	Cache &t = GetCache ();
+	t.hits = 0;
+	t.misses = 0;
+	t.picoEmUso = t.emUso;
+}
+
+// Contadores da thread que chama; slabBytes é do processo
+inline Estatisticas
+GetStats (void)
+{
+	Cache &t = GetCache ();
+	Estatisticas s;
+	s.hits = t.hits;
+	s.misses = t.misses;
+	s.emUso = t.emUso > 0 ? t.emUso : 0;
+	s.picoEmUso = t.picoEmUso > 0 ? t.picoEmUso : 0;
+	Estado &e = GetEstado ();
+	Travar (e);
+	s.slabBytes = e.slabBytes;
+	Destravar (e);
+	return s;
+}
+
+// Vai para o std::cerr para não misturar com o CSV do std::cout.
+inline void
+PrintStats (std::ostream &os, uint32_t nWifi, uint32_t k)
+{
+	Estatisticas s = GetStats ();
+	double total = (double) (s.hits + s.misses);
+	os << "pool;" << nWifi << ";" << k
+	   << ";hits=" << s.hits
+	   << ";misses=" << s.misses
+	   << ";hitRatio=" << (total > 0 ? s.hits / total : 0.0)
+	   << ";picoEmUso=" << s.picoEmUso
+	   << ";slabBytes=" << s.slabBytes
+	   << "\n";
+}
+
+} // namespace PacketPool
+
+#endif /* PACKET_POOL_H */
@@ -0,0 +1,126 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "ns3/core-module.h"
+#include "ns3/network-module.h"
+#include "ns3/internet-module.h"
+#include "packetPoolNew.h"
+#include <vector>
+#include <sys/time.h>
+#include <sys/resource.h>
+
+// Benchmark do packetPool.h: reproduz o padrão de alocação do caminho de dados
+// dos cenários CBR (pacote de 450 bytes, cabeçalhos UDP e IPv4, cópia no
+// enfileiramento, destruição no receptor) sem o custo do MAC/PHY.
+//
+// Obs:
+// Rodar uma vez com e outra sem pool e comparar Pacotes/s. Com --pool=0
+// new/delete só repassam para malloc/free, é a base de comparação. O pico
+// de RSS é do processo inteiro; o pool guarda os slabs, então não o reduz.
+// executar comando : ./waf --run "packetPoolBench --pool=0" e "--pool=1"
+
+
+using namespace ns3;
+using namespace std;
+
+NS_LOG_COMPONENT_DEFINE ("PacketPoolBenchProgram");
+
+
+// Pico de RSS do processo em KiB (ru_maxrss no Linux).
+long picoRss (void) {
+	struct rusage uso;
+	getrusage (RUSAGE_SELF, &uso);
+	return uso.ru_maxrss;
+}
+
+double agora (void) {
+	struct timeval tv;
+	gettimeofday (&tv, 0);
+	return tv.tv_sec + tv.tv_usec / 1e6;
+}
+
+
+int main (int argc, char *argv[]) {
+	bool pool = true;
+	uint32_t nWifi = 40;
+	uint32_t nPacotes = 2000000;
+	uint32_t emVoo = 64;
+	uint64_t packetSize = 450;
+
+	CommandLine cmd;
+	cmd.AddValue ("pool", "Use the size-classed packet pool", pool);
+	cmd.AddValue ("nWifi", "Number of stations (one queue each)", nWifi);
+	cmd.AddValue ("nPacotes", "Total number of packets created", nPacotes);
+	cmd.AddValue ("emVoo", "Packets kept alive per station queue", emVoo);
+	cmd.AddValue ("packetSize", "Payload size in bytes", packetSize);
+	cmd.Parse (argc,argv);
+
+	PacketPool::Enable (pool);
+	PacketPool::ResetStats ();
+
+	// Uma fila por estação, como as filas do WifiMacQueue/PointToPoint
+	std::vector< std::vector< Ptr<Packet> > > filas (nWifi);
+	for (uint32_t i = 0; i < nWifi; i++) {
+		filas[i].resize (emVoo);
+	}
+
+	UdpHeader udp;
+	udp.SetSourcePort (49153);
+	udp.SetDestinationPort (200);
+	Ipv4Header ip;
+	ip.SetSource (Ipv4Address ("192.168.0.2"));
+	ip.SetDestination (Ipv4Address ("10.0.0.2"));
+	ip.SetProtocol (17);
+	ip.SetPayloadSize (packetSize + 8);
+
+	uint64_t bytes = 0;
+	double inicio = agora ();
+	for (uint32_t n = 0; n < nPacotes; n++) {
+		Ptr<Packet> p = Create<Packet> (packetSize);
+		p->AddHeader (udp);
+		p->AddHeader (ip);
+
+		// cópia feita pelo MAC ao enfileirar, a anterior morre no receptor
+		uint32_t fila = n % nWifi;
+		uint32_t pos = (n / nWifi) % emVoo;
+		filas[fila][pos] = p->Copy ();
+		bytes += p->GetSize ();
+	}
+	for (uint32_t i = 0; i < nWifi; i++) {
+		filas[i].clear ();
+	}
+	double duracao = agora () - inicio;
+
+	std::cout << "Pool;";
+	std::cout << "nPacotes;";
+	std::cout << "Bytes;";
+	std::cout << "Tempo(s);";
+	std::cout << "Pacotes/s;";
+	std::cout << "PicoRss(KiB);";
+	std::cout << "\n";
+
+	std::cout << pool << ";";
+	std::cout << nPacotes << ";";
+	std::cout << bytes << ";";
+	std::cout << duracao << ";";
+	std::cout << nPacotes / duracao << ";";
+	std::cout << picoRss () << ";";
+	std::cout << "\n";
+
+	PacketPool::PrintStats (std::cerr, nWifi, 1);
+
+	return 0;
+}
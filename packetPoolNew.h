@@ -0,0 +1,110 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef PACKET_POOL_NEW_H
+#define PACKET_POOL_NEW_H
+
+// Liga o pool de packetPool.h ao operator new/delete global. Só os
+// programas que incluem este arquivo aceitam --pool; nos demais new/delete
+// continuam os da biblioteca. Com o pool desligado as substituições só
+// repassam para malloc/free.
+
+#include "packetPool.h"
+
+// Substituições globais. Não podem ser inline (regra do padrão), por isso o
+// header só pode ser incluído por um .cc em cada programa.
+
+namespace PacketPool {
+
+inline bool
+MarcarInstalado (void)
+{
+	GetEstado ().instalado = true;
+	return true;
+}
+
+static const bool g_instalado = MarcarInstalado ();
+
+} // namespace PacketPool
+
+void *
+operator new (std::size_t n)
+{
+	void *p = PacketPool::Alocar (n);
+	if (p == 0)
+	{
+		throw std::bad_alloc ();
+	}
+	return p;
+}
+
+void *
+operator new (std::size_t n, const std::nothrow_t &) noexcept
+{
+	return PacketPool::Alocar (n);
+}
+
+void *
+operator new[] (std::size_t n)
+{
+	return operator new (n);
+}
+
+void *
+operator new[] (std::size_t n, const std::nothrow_t &t) noexcept
+{
+	return operator new (n, t);
+}
+
+void
+operator delete (void *p) noexcept
+{
+	PacketPool::Liberar (p);
+}
+
+void
+operator delete (void *p, const std::nothrow_t &) noexcept
+{
+	PacketPool::Liberar (p);
+}
+
+void
+operator delete[] (void *p) noexcept
+{
+	PacketPool::Liberar (p);
+}
+
+void
+operator delete[] (void *p, const std::nothrow_t &) noexcept
+{
+	PacketPool::Liberar (p);
+}
+
+#ifdef __cpp_sized_deallocation
+void
+operator delete (void *p, std::size_t) noexcept
+{
+	PacketPool::Liberar (p);
+}
+
+void
+operator delete[] (void *p, std::size_t) noexcept
+{
+	PacketPool::Liberar (p);
+}
+#endif
+
+#endif /* PACKET_POOL_NEW_H */
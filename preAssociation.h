@@ -0,0 +1,145 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef PRE_ASSOCIATION_H
+#define PRE_ASSOCIATION_H
+
+// Estações que já começam associadas ao AP (--preAssociado).
+//
+// Com ActiveProbing = false a StaWifiMac espera um beacon, manda o
+// association request e só depois da resposta aceita dados; até lá o
+// Enqueue descarta. Com muitas estações isso leva tempo simulado e muitos
+// eventos (requests disputando o meio logo depois de cada beacon).
+//
+// O estado de associação da StaWifiMac do ns-3.26 é privado, então a
+// PreAssociatedStaWifiMac não passa por ele: o Enqueue monta o cabeçalho
+// como a StaWifiMac faz depois de associada, e o Receive entrega os dados
+// vindos do AP e ignora beacons e respostas de associação (não há mais o
+// que fazer com eles). AssociarEstacoes fixa o BSSID e as taxas do AP em
+// cada estação e marca cada estação como associada no gerenciador de
+// estações do AP, que é o que o ApWifiMac confere ao receber dados.
+//
+// Os beacons do AP continuam, como em regime.
+
+#include "ns3/core-module.h"
+#include "ns3/network-module.h"
+#include "ns3/wifi-module.h"
+
+namespace ns3 {
+
+class PreAssociatedStaWifiMac : public StaWifiMac
+{
+public:
+	static TypeId GetTypeId (void)
+	{
+		static TypeId tid = TypeId ("ns3::PreAssociatedStaWifiMac")
+			.SetParent<StaWifiMac> ()
+			.AddConstructor<PreAssociatedStaWifiMac> ();
+		return tid;
+	}
+
+	// Chamado por AssociarEstacoes, antes do Simulator::Run
+	void Associar (Mac48Address bssid)
+	{
+		SetBssid (bssid);
+		m_stationManager->AddAllSupportedModes (bssid);
+		m_linkUp ();
+	}
+
+	virtual void Enqueue (Ptr<const Packet> packet, Mac48Address to)
+	{
+		WifiMacHeader hdr;
+		if (m_qosSupported) {
+			hdr.SetType (WIFI_MAC_QOSDATA);
+			hdr.SetQosAckPolicy (WifiMacHeader::NORMAL_ACK);
+			hdr.SetQosNoEosp ();
+			hdr.SetQosNoAmsdu ();
+			hdr.SetQosTxopLimit (0);
+		} else {
+			hdr.SetTypeData ();
+		}
+		if (m_htSupported || m_vhtSupported) {
+			hdr.SetNoOrder ();
+		}
+		hdr.SetAddr1 (GetBssid ());
+		hdr.SetAddr2 (GetAddress ());
+		hdr.SetAddr3 (to);
+		hdr.SetDsNotFrom ();
+		hdr.SetDsTo ();
+
+		if (m_qosSupported) {
+			uint8_t tid = QosUtilsGetTidForPacket (packet);
+			if (tid > 7) {
+				tid = 0;
+			}
+			hdr.SetQosTid (tid);
+			m_edca[QosUtilsMapTidToAc (tid)]->Queue (packet, hdr);
+		} else {
+			m_dca->Queue (packet, hdr);
+		}
+	}
+
+private:
+	virtual void Receive (Ptr<Packet> packet, const WifiMacHeader *hdr)
+	{
+		if (hdr->GetAddr3 () == GetAddress ()) {
+			return;
+		}
+		if (hdr->GetAddr1 () != GetAddress () && !hdr->GetAddr1 ().IsGroup ()) {
+			return;
+		}
+		if (hdr->IsData ()) {
+			if (hdr->IsQosData () && hdr->IsQosAmsdu ()) {
+				DeaggregateAmsduAndForward (packet, hdr);
+			} else {
+				ForwardUp (packet, hdr->GetAddr3 (), hdr->GetAddr1 ());
+			}
+			return;
+		}
+		// Beacon, probe e associação: a estação já está associada
+		if (hdr->IsAction ()) {
+			RegularWifiMac::Receive (packet, hdr);
+		}
+	}
+};
+
+NS_OBJECT_ENSURE_REGISTERED (PreAssociatedStaWifiMac);
+
+
+// estacoes instaladas com mac.SetType ("ns3::PreAssociatedStaWifiMac", ...)
+inline void
+AssociarEstacoes (const NetDeviceContainer &estacoes, Ptr<NetDevice> ap)
+{
+	Ptr<WifiNetDevice> apWifi = DynamicCast<WifiNetDevice> (ap);
+	Mac48Address bssid = apWifi->GetMac ()->GetAddress ();
+	Ptr<WifiRemoteStationManager> gerente = apWifi->GetRemoteStationManager ();
+
+	for (uint32_t i = 0; i < estacoes.GetN (); i++) {
+		Ptr<WifiNetDevice> sta = DynamicCast<WifiNetDevice> (estacoes.Get (i));
+		Ptr<PreAssociatedStaWifiMac> mac = DynamicCast<PreAssociatedStaWifiMac> (sta->GetMac ());
+		NS_ABORT_MSG_IF (mac == 0, "Estacao " << i << " nao usa ns3::PreAssociatedStaWifiMac");
+		mac->Associar (bssid);
+
+		Mac48Address endereco = mac->GetAddress ();
+		gerente->AddAllSupportedModes (endereco);
+		gerente->RecordWaitAssocTxOk (endereco);
+		gerente->RecordGotAssocTxOk (endereco);
+	}
+}
+
+} // namespace ns3
+
+#endif /* PRE_ASSOCIATION_H */
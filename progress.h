@@ -0,0 +1,359 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef PROGRESS_H
+#define PROGRESS_H
+
+// Progresso da varredura: arquivo de status e, opcionalmente, HTTP em
+// localhost.
+//
+// Dentro de cada rodada um AmostradorProgresso é agendado pelo sweepRunner
+// antes de simular (não precisa de nada no programa) e, a cada periodo de
+// tempo simulado, grava tempo simulado, tempo de relógio e eventos
+// executados numa AmostraProgresso: o slot da rodada na ResultArena, no
+// caso dos workers, ou uma variável do próprio runner com --jobs=1. São
+// três stores por amostra; o evento a mais não muda a ordem relativa dos
+// eventos do modelo nem os streams, então o resultado é o mesmo.
+//
+// O RelatorioProgresso, no processo que coordena, junta as amostras das
+// rodadas ativas, as contagens de concluídas e pendentes e uma ETA por
+// modelo de custo (tempo de relógio por rodada x nWifi, ajuste em escala
+// log-log das rodadas já terminadas), e no máximo uma vez por segundo
+// reescreve o arquivo de status (tmp + rename). Com porta, o mesmo texto
+// é servido em http://127.0.0.1:<porta>/; o socket é não bloqueante e
+// atendido no mesmo laço, sem thread.
+
+#include "ns3/core-module.h"
+#include "resultArena.h"
+#include <string>
+#include <vector>
+#include <sstream>
+#include <functional>
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <cerrno>
+#include <unistd.h>
+#include <fcntl.h>
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <arpa/inet.h>
+
+namespace ns3 {
+
+inline double
+RelogioProgresso (void)
+{
+	return std::chrono::duration<double> (std::chrono::steady_clock::now ().time_since_epoch ()).count ();
+}
+
+class AmostradorProgresso
+{
+public:
+	AmostradorProgresso ()
+		: m_destino (0),
+		  m_periodo (0.1),
+		  m_inicio (0.0),
+		  m_eventos0 (0)
+	{
+	}
+
+	// Antes do Simulator::Run da rodada; destino 0 e sem aoAmostrar não agenda
+	void Iniciar (AmostraProgresso *destino, std::function<void ()> aoAmostrar = std::function<void ()> ())
+	{
+		m_destino = destino;
+		m_aoAmostrar = aoAmostrar;
+		if (m_destino == 0 && !m_aoAmostrar) {
+			return;
+		}
+		m_inicio = RelogioProgresso ();
+		m_eventos0 = Simulator::GetEventCount ();
+		Simulator::Schedule (Seconds (m_periodo), &AmostradorProgresso::Amostrar, this);
+	}
+
+private:
+	void Amostrar (void)
+	{
+		if (m_destino != 0) {
+			double simulado = Simulator::Now ().GetSeconds ();
+			double relogio = RelogioProgresso () - m_inicio;
+			uint64_t eventos = Simulator::GetEventCount () - m_eventos0;
+			__atomic_store (&m_destino->simulado, &simulado, __ATOMIC_RELAXED);
+			__atomic_store (&m_destino->relogio, &relogio, __ATOMIC_RELAXED);
+			__atomic_store (&m_destino->eventos, &eventos, __ATOMIC_RELAXED);
+		}
+		if (m_aoAmostrar) {
+			m_aoAmostrar ();
+		}
+		Simulator::Schedule (Seconds (m_periodo), &AmostradorProgresso::Amostrar, this);
+	}
+
+	AmostraProgresso *m_destino;
+	std::function<void ()> m_aoAmostrar;
+	double m_periodo;
+	double m_inicio;
+	uint64_t m_eventos0;
+};
+
+// Segundos de relógio por rodada: c * nWifi^alfa. Com um nWifi só, alfa = 1.
+class ModeloCusto
+{
+public:
+	void Adicionar (uint32_t nWifi, double segundos)
+	{
+		if (nWifi > 0 && segundos > 0.0) {
+			m_x.push_back (std::log ((double) nWifi));
+			m_y.push_back (std::log (segundos));
+		}
+	}
+
+	bool Calibrado (void) const
+	{
+		return !m_x.empty ();
+	}
+
+	double Prever (uint32_t nWifi) const
+	{
+		uint32_t k = m_x.size ();
+		double mx = 0.0, my = 0.0;
+		for (uint32_t i = 0; i < k; i++) {
+			mx += m_x[i];
+			my += m_y[i];
+		}
+		mx /= k;
+		my /= k;
+		double sxx = 0.0, sxy = 0.0;
+		for (uint32_t i = 0; i < k; i++) {
+			sxx += (m_x[i] - mx) * (m_x[i] - mx);
+			sxy += (m_x[i] - mx) * (m_y[i] - my);
+		}
+		double alfa = sxx > 0.0 ? sxy / sxx : 1.0;
+		return std::exp (my + alfa * (std::log ((double) std::max (nWifi, 1u)) - mx));
+	}
+
+private:
+	std::vector<double> m_x;
+	std::vector<double> m_y;
+};
+
+class RelatorioProgresso
+{
+public:
+	struct Ativa {
+		int pid;
+		uint32_t nWifi;
+		uint32_t k;
+		double inicio;              // RelogioProgresso () no lançamento
+		AmostraProgresso amostra;   // zerada enquanto não houver amostra
+	};
+
+	RelatorioProgresso (std::string cenario, std::string arquivo, uint32_t porta)
+		: m_cenario (cenario),
+		  m_arquivo (arquivo),
+		  m_socket (-1),
+		  m_inicio (RelogioProgresso ()),
+		  m_ultima (0.0),
+		  m_total (0),
+		  m_concluidas (0),
+		  m_reaproveitadas (0)
+	{
+		if (porta > 0) {
+			Escutar (porta);
+		}
+	}
+
+	~RelatorioProgresso ()
+	{
+		if (m_socket >= 0) {
+			close (m_socket);
+		}
+		for (uint32_t i = 0; i < m_clientes.size (); i++) {
+			close (m_clientes[i].fd);
+		}
+	}
+
+	bool Ativo (void) const
+	{
+		return !m_arquivo.empty () || m_socket >= 0;
+	}
+
+	// Rodadas novas da varredura; reaproveitadas vieram do journal ou cache
+	void Adicionar (uint32_t simular, uint32_t reaproveitadas)
+	{
+		m_total += simular + reaproveitadas;
+		m_reaproveitadas += reaproveitadas;
+	}
+
+	void Concluida (uint32_t nWifi, double segundos)
+	{
+		m_concluidas++;
+		m_custo.Adicionar (nWifi, segundos);
+	}
+
+	// Passou o intervalo de atualização: quem chama monta as listas só então
+	bool Vencido (void) const
+	{
+		return Ativo () && RelogioProgresso () - m_ultima >= 1.0;
+	}
+
+	// Refaz o texto e o arquivo se passou um segundo (ou forcar)
+	void Atualizar (const std::vector<Ativa> &ativas, const std::vector<uint32_t> &fila, uint32_t jobs, bool forcar = false)
+	{
+		double agora = RelogioProgresso ();
+		if (!Ativo () || (!forcar && agora - m_ultima < 1.0)) {
+			return;
+		}
+		m_ultima = agora;
+
+		double restante = 0.0;
+		for (uint32_t i = 0; i < ativas.size (); i++) {
+			restante += std::max (0.0, Custo (ativas[i].nWifi) - (agora - ativas[i].inicio));
+		}
+		for (uint32_t i = 0; i < fila.size (); i++) {
+			restante += Custo (fila[i]);
+		}
+		uint32_t paralelo = std::max (1u, std::min (jobs, (uint32_t) (ativas.size () + fila.size ())));
+
+		std::ostringstream oss;
+		oss << "cenario;" << m_cenario << "\n";
+		oss << "rodadas;" << m_total << "\n";
+		oss << "concluidas;" << m_concluidas + m_reaproveitadas << "\n";
+		oss << "reaproveitadas;" << m_reaproveitadas << "\n";
+		oss << "ativas;" << ativas.size () << "\n";
+		oss << "na fila;" << fila.size () << "\n";
+		oss << "decorrido(s);" << agora - m_inicio << "\n";
+		if (m_custo.Calibrado ()) {
+			oss << "eta(s);" << restante / paralelo << "\n";
+		} else {
+			oss << "eta(s);?\n";
+		}
+		oss << "worker;nWifi;k;simulado(s);relogio(s);eventos;eventos/s;\n";
+		double eventosSegundo = 0.0;
+		for (uint32_t i = 0; i < ativas.size (); i++) {
+			const AmostraProgresso &a = ativas[i].amostra;
+			double taxa = a.relogio > 0.0 ? a.eventos / a.relogio : 0.0;
+			eventosSegundo += taxa;
+			oss << ativas[i].pid << ";" << ativas[i].nWifi << ";" << ativas[i].k << ";" << a.simulado << ";"
+				<< a.relogio << ";" << a.eventos << ";" << taxa << ";\n";
+		}
+		oss << "total;;;;;;" << eventosSegundo << ";\n";
+		m_texto = oss.str ();
+
+		if (!m_arquivo.empty ()) {
+			std::string tmp = m_arquivo + ".tmp";
+			FILE *f = fopen (tmp.c_str (), "w");
+			if (f != 0) {
+				bool ok = fwrite (m_texto.data (), 1, m_texto.size (), f) == m_texto.size ();
+				ok = fclose (f) == 0 && ok;
+				if (ok) {
+					rename (tmp.c_str (), m_arquivo.c_str ());
+				}
+			}
+		}
+	}
+
+	// Responde às conexões pendentes com o último texto; não bloqueia. Um
+	// cliente só é respondido depois de mandar o pedido; quem não manda
+	// nada em 1 s é fechado.
+	void Atender (void)
+	{
+		if (m_socket < 0) {
+			return;
+		}
+		double agora = RelogioProgresso ();
+		int fd;
+		while ((fd = accept4 (m_socket, 0, 0, SOCK_NONBLOCK | SOCK_CLOEXEC)) >= 0) {
+			Cliente c = { fd, agora };
+			m_clientes.push_back (c);
+		}
+		uint32_t mantidos = 0;
+		for (uint32_t i = 0; i < m_clientes.size (); i++) {
+			// O pedido em si não importa; lê para o cliente não levar RST
+			char pedido[1024];
+			ssize_t lidos = recv (m_clientes[i].fd, pedido, sizeof (pedido), MSG_DONTWAIT);
+			if (lidos < 0 && (errno == EAGAIN || errno == EWOULDBLOCK) && agora - m_clientes[i].desde < 1.0) {
+				m_clientes[mantidos++] = m_clientes[i];
+				continue;
+			}
+			if (lidos > 0) {
+				std::ostringstream oss;
+				oss << "HTTP/1.0 200 OK\r\nContent-Type: text/plain; charset=utf-8\r\nContent-Length: "
+					<< m_texto.size () << "\r\nConnection: close\r\n\r\n" << m_texto;
+				std::string resposta = oss.str ();
+				ssize_t enviados = send (m_clientes[i].fd, resposta.data (), resposta.size (), MSG_NOSIGNAL | MSG_DONTWAIT);
+				(void) enviados;
+			}
+			close (m_clientes[i].fd);
+		}
+		m_clientes.resize (mantidos);
+	}
+
+private:
+	RelatorioProgresso (const RelatorioProgresso &);
+	RelatorioProgresso &operator= (const RelatorioProgresso &);
+
+	void Escutar (uint32_t porta)
+	{
+		m_socket = socket (AF_INET, SOCK_STREAM, 0);
+		if (m_socket < 0) {
+			perror ("progresso: socket");
+			return;
+		}
+		int sim = 1;
+		setsockopt (m_socket, SOL_SOCKET, SO_REUSEADDR, &sim, sizeof (sim));
+		struct sockaddr_in endereco;
+		memset (&endereco, 0, sizeof (endereco));
+		endereco.sin_family = AF_INET;
+		endereco.sin_port = htons (porta);
+		endereco.sin_addr.s_addr = htonl (INADDR_LOOPBACK);
+		if (bind (m_socket, (struct sockaddr *) &endereco, sizeof (endereco)) != 0 || listen (m_socket, 8) != 0) {
+			perror ("progresso: bind");
+			close (m_socket);
+			m_socket = -1;
+			return;
+		}
+		fcntl (m_socket, F_SETFL, fcntl (m_socket, F_GETFL) | O_NONBLOCK);
+		fcntl (m_socket, F_SETFD, FD_CLOEXEC);
+	}
+
+	double Custo (uint32_t nWifi) const
+	{
+		return m_custo.Calibrado () ? m_custo.Prever (nWifi) : 0.0;
+	}
+
+	struct Cliente {
+		int fd;
+		double desde;   // RelogioProgresso () no accept
+	};
+
+	std::string m_cenario;
+	std::string m_arquivo;
+	int m_socket;
+	std::vector<Cliente> m_clientes;   // aceitos, esperando o pedido
+	double m_inicio;
+	double m_ultima;
+	uint32_t m_total;
+	uint32_t m_concluidas;
+	uint32_t m_reaproveitadas;
+	ModeloCusto m_custo;
+	std::string m_texto;
+};
+
+} // namespace ns3
+
+#endif /* PROGRESS_H */
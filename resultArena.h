@@ -0,0 +1,255 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef RESULT_ARENA_H
+#define RESULT_ARENA_H
+
+// Arena de resultados em memória compartilhada entre o sweepRunner e os
+// workers.
+//
+// Tabela de layout fixo: um slot por trabalho, cada um com um cabeçalho
+// (estado, número de fluxos, flags, duração) e espaço para "capacidade"
+// ResultadoFluxo. O worker copia os registros direto no slot e só então
+// publica o estado PRONTO (store release); o pai vê o estado (load acquire)
+// e lê os registros do slot, sem arquivo e sem serialização, enquanto os
+// outros workers continuam simulando.
+//
+// O arquivo é criado em /dev/shm e removido na hora; o mapeamento é
+// herdado pelo fork (--zygote) e o descritor, sem FD_CLOEXEC, pelo exec
+// (--workerArena=<fd>).
+//
+// O slot também leva a última AmostraProgresso da rodada em andamento
+// (progress.h), gravada pelo worker e lida pelo pai para o status, e o pico
+// de RSS que o worker mediu em si mesmo (--memBudget), gravado mesmo quando
+// a rodada não cabe no slot.
+
+#include "runResult.h"
+#include <vector>
+#include <cstring>
+#include <cstdlib>
+#include <stdint.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+// Gravada com stores relaxados campo a campo: o leitor pode ver campos de
+// amostras vizinhas, o que não importa para o status.
+struct AmostraProgresso {
+	double simulado;   // s simulados
+	double relogio;    // s de relógio desde o início da rodada
+	uint64_t eventos;
+};
+
+class ResultArena
+{
+public:
+	enum Estado { LIVRE = 0, PRONTO = 1 };
+
+	ResultArena ()
+		: m_fd (-1),
+		  m_base (0),
+		  m_tamanho (0)
+	{
+	}
+
+	~ResultArena ()
+	{
+		if (m_base != 0) {
+			munmap (m_base, m_tamanho);
+		}
+		if (m_fd >= 0) {
+			close (m_fd);
+		}
+	}
+
+	// Processo pai: slots zerados (LIVRE), cada um com capacidade fluxos
+	bool Criar (uint32_t slots, uint32_t capacidade)
+	{
+		char nome[] = "/dev/shm/resultados-XXXXXX";
+		m_fd = mkstemp (nome);
+		if (m_fd < 0) {
+			char alternativo[] = "/tmp/resultados-XXXXXX";
+			m_fd = mkstemp (alternativo);
+			if (m_fd < 0) {
+				return false;
+			}
+			unlink (alternativo);
+		} else {
+			unlink (nome);
+		}
+		size_t tamanho = INICIO + (size_t) slots * Passo (capacidade);
+		if (ftruncate (m_fd, tamanho) != 0) {
+			return false;
+		}
+		if (!Mapear (tamanho)) {
+			return false;
+		}
+		Cabecalho *c = (Cabecalho *) m_base;
+		c->magico = MAGICO;
+		c->slots = slots;
+		c->capacidade = capacidade;
+		return true;
+	}
+
+	// Worker depois do exec
+	bool Abrir (int fd)
+	{
+		struct stat st;
+		m_fd = fd;
+		if (fstat (fd, &st) != 0 || (size_t) st.st_size < INICIO) {
+			return false;
+		}
+		if (!Mapear (st.st_size)) {
+			return false;
+		}
+		const Cabecalho *c = (const Cabecalho *) m_base;
+		return c->magico == MAGICO && INICIO + (size_t) c->slots * Passo (c->capacidade) <= m_tamanho;
+	}
+
+	int GetFd (void) const
+	{
+		return m_fd;
+	}
+
+	// false se o slot não existe ou a rodada não cabe (o worker usa o arquivo)
+	bool Publicar (uint32_t slot, const ResultadoRodada &r)
+	{
+		const Cabecalho *c = (const Cabecalho *) m_base;
+		if (m_base == 0 || slot >= c->slots || r.fluxos.size () > c->capacidade) {
+			return false;
+		}
+		Slot *s = GetSlot (slot);
+		s->numFluxos = r.fluxos.size ();
+		s->flags = r.flags;
+		s->duracao = r.duracao;
+		if (!r.fluxos.empty ()) {
+			memcpy (Registros (s), &r.fluxos[0], r.fluxos.size () * sizeof (ResultadoFluxo));
+		}
+		__atomic_store_n (&s->estado, (uint32_t) PRONTO, __ATOMIC_RELEASE);
+		return true;
+	}
+
+	bool Pronto (uint32_t slot) const
+	{
+		return m_base != 0 && __atomic_load_n (&GetSlot (slot)->estado, __ATOMIC_ACQUIRE) == PRONTO;
+	}
+
+	// 0 se o slot não existe
+	AmostraProgresso *Progresso (uint32_t slot)
+	{
+		if (m_base == 0 || slot >= ((const Cabecalho *) m_base)->slots) {
+			return 0;
+		}
+		return &GetSlot (slot)->progresso;
+	}
+
+	void LerProgresso (uint32_t slot, AmostraProgresso &a) const
+	{
+		const AmostraProgresso &p = GetSlot (slot)->progresso;
+		__atomic_load (&p.simulado, &a.simulado, __ATOMIC_RELAXED);
+		__atomic_load (&p.relogio, &a.relogio, __ATOMIC_RELAXED);
+		__atomic_load (&p.eventos, &a.eventos, __ATOMIC_RELAXED);
+	}
+
+	// KiB; o pai lê depois que o worker saiu
+	void GravarPicoRss (uint32_t slot, uint64_t kib)
+	{
+		if (m_base != 0 && slot < ((const Cabecalho *) m_base)->slots) {
+			__atomic_store_n (&GetSlot (slot)->picoRss, kib, __ATOMIC_RELAXED);
+		}
+	}
+
+	// 0 se o worker não gravou
+	uint64_t LerPicoRss (uint32_t slot) const
+	{
+		if (m_base == 0) {
+			return 0;
+		}
+		return __atomic_load_n (&GetSlot (slot)->picoRss, __ATOMIC_RELAXED);
+	}
+
+	// Só depois de Pronto (slot). Copia os registros: a arena é desfeita
+	// no fim do ExecutarProcessos e o resultado continua sendo usado pelas
+	// tabelas e pelas próximas etapas da varredura adaptativa.
+	void Ler (uint32_t slot, ResultadoRodada &r) const
+	{
+		const Slot *s = GetSlot (slot);
+		const ResultadoFluxo *f = Registros (s);
+		r.fluxos.assign (f, f + s->numFluxos);
+		r.flags = s->flags;
+		r.duracao = s->duracao;
+	}
+
+private:
+	static const uint32_t MAGICO = 0x52415245;
+	static const size_t INICIO = 64;   // cabeçalho numa linha de cache só dele
+
+	struct Cabecalho {
+		uint32_t magico;
+		uint32_t slots;
+		uint32_t capacidade;
+		uint32_t reservado;
+	};
+
+	struct Slot {
+		uint32_t estado;
+		uint32_t numFluxos;
+		uint32_t flags;
+		uint32_t reservado;
+		double duracao;
+		uint64_t picoRss;
+		AmostraProgresso progresso;
+	};
+
+	ResultArena (const ResultArena &);
+	ResultArena &operator= (const ResultArena &);
+
+	// Slots alinhados a 64 bytes: workers vizinhos não dividem linha de cache
+	static size_t Passo (uint32_t capacidade)
+	{
+		size_t passo = sizeof (Slot) + (size_t) capacidade * sizeof (ResultadoFluxo);
+		return (passo + 63) & ~(size_t) 63;
+	}
+
+	bool Mapear (size_t tamanho)
+	{
+		void *p = mmap (0, tamanho, PROT_READ | PROT_WRITE, MAP_SHARED, m_fd, 0);
+		if (p == MAP_FAILED) {
+			return false;
+		}
+		m_base = (char *) p;
+		m_tamanho = tamanho;
+		return true;
+	}
+
+	Slot *GetSlot (uint32_t slot) const
+	{
+		const Cabecalho *c = (const Cabecalho *) m_base;
+		return (Slot *) (m_base + INICIO + slot * Passo (c->capacidade));
+	}
+
+	static ResultadoFluxo *Registros (const Slot *s)
+	{
+		return (ResultadoFluxo *) ((char *) s + sizeof (Slot));
+	}
+
+	int m_fd;
+	char *m_base;
+	size_t m_tamanho;
+};
+
+#endif /* RESULT_ARENA_H */
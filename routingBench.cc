@@ -0,0 +1,171 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "ns3/core-module.h"
+#include "ns3/point-to-point-module.h"
+#include "ns3/network-module.h"
+#include "ns3/wifi-module.h"
+#include "ns3/internet-module.h"
+#include "starRouting.h"
+#include "sweep.h"
+#include <sys/time.h>
+
+// Benchmark do starRouting.h: tempo para montar as rotas da estrela com o
+// Ipv4GlobalRoutingHelper e com o InstalarRotasEstrela.
+//
+// A topologia é a dos programas (servidor -p2p- AP -wifi- estações), mas com
+// a rede wifi em /16 para caber mais de 250 estações. Só a chamada de rotas
+// entra no tempo; Montagem(s) é o resto (nós, devices, pilha, endereços),
+// para comparar. RotaOk confere, pelo RouteOutput, que a primeira estação
+// chega ao servidor pelo AP e o servidor à última estação pelo AP.
+//
+// Obs:
+// executar comando : ./waf --run "routingBench --nWifi=250,1000,5000"
+
+
+using namespace ns3;
+using namespace std;
+
+NS_LOG_COMPONENT_DEFINE ("RoutingBenchProgram");
+
+
+double agora (void) {
+	struct timeval tv;
+	gettimeofday (&tv, 0);
+	return tv.tv_sec + tv.tv_usec / 1e6;
+}
+
+
+bool rotaPor (Ptr<Node> origem, Ipv4Address destino, Ipv4Address gateway) {
+	Ptr<Ipv4> ipv4 = origem->GetObject<Ipv4> ();
+	Ipv4Header cabecalho;
+	cabecalho.SetDestination (destino);
+	Socket::SocketErrno erro;
+	Ptr<Ipv4Route> rota = ipv4->GetRoutingProtocol ()->RouteOutput (Create<Packet> (), cabecalho, 0, erro);
+	return rota != 0 && rota->GetGateway () == gateway;
+}
+
+
+void medir (uint32_t nWifi, bool global) {
+	double inicio = agora ();
+
+	NodeContainer serverNode;
+	serverNode.Create (1);
+	NodeContainer wifiApNode;
+	wifiApNode.Create (1);
+	NodeContainer wifiStaNodes;
+	wifiStaNodes.Create (nWifi);
+
+	PointToPointHelper pointToPoint;
+	NetDeviceContainer p2pDevices;
+	p2pDevices = pointToPoint.Install (wifiApNode.Get (0), serverNode.Get (0));
+
+	YansWifiChannelHelper channel = YansWifiChannelHelper::Default ();
+	YansWifiPhyHelper phy = YansWifiPhyHelper::Default ();
+	phy.SetChannel (channel.Create ());
+
+	WifiHelper wifi;
+	wifi.SetRemoteStationManager ("ns3::AarfWifiManager");
+	WifiMacHelper mac;
+	Ssid ssid = Ssid ("ns-3-ssid");
+
+	mac.SetType ("ns3::StaWifiMac", "Ssid", SsidValue (ssid), "ActiveProbing", BooleanValue (false));
+	NetDeviceContainer staDevices;
+	staDevices = wifi.Install (phy, mac, wifiStaNodes);
+
+	mac.SetType ("ns3::ApWifiMac", "Ssid", SsidValue (ssid));
+	NetDeviceContainer apDevices;
+	apDevices = wifi.Install (phy, mac, wifiApNode);
+
+	InternetStackHelper stack;
+	stack.Install (serverNode);
+	stack.Install (wifiApNode);
+	stack.Install (wifiStaNodes);
+
+	Ipv4AddressHelper address;
+	address.SetBase ("10.0.0.0", "255.255.255.0");
+	Ipv4InterfaceContainer p2pInterfaces;
+	p2pInterfaces = address.Assign (p2pDevices);
+
+	address.SetBase ("192.168.0.0", "255.255.0.0");
+	Ipv4InterfaceContainer apInterfaces;
+	apInterfaces = address.Assign (apDevices);
+	Ipv4InterfaceContainer staInterfaces;
+	staInterfaces = address.Assign (staDevices);
+
+	double montagem = agora () - inicio;
+
+	inicio = agora ();
+	if (global) {
+		Ipv4GlobalRoutingHelper::PopulateRoutingTables ();
+	} else {
+		InstalarRotasEstrela (staInterfaces, apInterfaces.GetAddress (0), p2pInterfaces);
+	}
+	double rotas = agora () - inicio;
+
+	bool ok = rotaPor (wifiStaNodes.Get (0), p2pInterfaces.GetAddress (1), apInterfaces.GetAddress (0))
+		&& rotaPor (serverNode.Get (0), staInterfaces.GetAddress (nWifi - 1), p2pInterfaces.GetAddress (0));
+
+	std::cout << nWifi << ";";
+	std::cout << (global ? "global" : "estrela") << ";";
+	std::cout << montagem << ";";
+	std::cout << rotas << ";";
+	std::cout << ok << ";";
+	std::cout << "\n";
+
+	Simulator::Destroy ();
+}
+
+
+int main (int argc, char *argv[]) {
+	std::string nWifiLista = "250,1000,5000";
+	bool global = true;
+	bool estrela = true;
+
+	CommandLine cmd;
+	cmd.AddValue ("nWifi", "Station counts (same syntax as the sweep nWifi axis)", nWifiLista);
+	cmd.AddValue ("global", "Measure Ipv4GlobalRoutingHelper::PopulateRoutingTables", global);
+	cmd.AddValue ("estrela", "Measure InstalarRotasEstrela", estrela);
+	cmd.Parse (argc,argv);
+
+	std::vector<uint32_t> nWifis;
+	std::string erro;
+	if (!ExpandirEspecInteiro (nWifiLista, nWifis, erro)) {
+		std::cerr << "nWifi: " << erro << "\n";
+		return 1;
+	}
+
+	std::cout << "NWifi;";
+	std::cout << "Modo;";
+	std::cout << "Montagem(s);";
+	std::cout << "Rotas(s);";
+	std::cout << "RotaOk;";
+	std::cout << "\n";
+
+	for (uint32_t i = 0; i < nWifis.size (); i++) {
+		if (nWifis[i] == 0) {
+			continue;
+		}
+		if (global) {
+			medir (nWifis[i], true);
+		}
+		if (estrela) {
+			medir (nWifis[i], false);
+		}
+	}
+
+	return 0;
+}
@@ -0,0 +1,182 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef RUN_CACHE_H
+#define RUN_CACHE_H
+
+// Cache de resultados por rodada.
+//
+// A chave é o texto "cenario;nWifi;k;parâmetros do programa;atributos;ns-3"
+// onde os atributos são TODOS os valores iniciais registrados no TypeId e os
+// GlobalValue (pega Config::SetDefault e --ns3::...), e a versão do ns-3 vem
+// do nome da libns3.XX-core. O arquivo <dir>/<cenario>/<hash>.run guarda a
+// chave completa e o ResultadoRodada; se a chave não bater (colisão ou
+// arquivo de outra versão) a rodada é simulada de novo.
+
+#include "ns3/core-module.h"
+#include "runResult.h"
+#include <string>
+#include <sstream>
+#include <cstdio>
+#include <cerrno>
+#include <dlfcn.h>
+#include <sys/stat.h>
+#include <sys/types.h>
+#include <unistd.h>
+
+namespace ns3 {
+
+// "ns3.26" a partir de libns3.26-core-debug.so; o ns-3 desta época não
+// exporta a versão em nenhum header.
+inline std::string
+VersaoNs3 (void)
+{
+	Dl_info info;
+	void (*simbolo) (void) = &Simulator::Run;
+	if (dladdr ((void *) simbolo, &info) == 0 || info.dli_fname == 0) {
+		return "desconhecida";
+	}
+	std::string lib = info.dli_fname;
+	size_t barra = lib.rfind ('/');
+	if (barra != std::string::npos) {
+		lib = lib.substr (barra + 1);
+	}
+	size_t ini = lib.find ("ns3");
+	size_t fim = lib.find ("-core");
+	if (ini == std::string::npos || fim == std::string::npos || fim < ini) {
+		return lib;
+	}
+	return lib.substr (ini, fim - ini);
+}
+
+// Valores iniciais de todos os atributos e GlobalValues, um por linha.
+inline std::string
+AtributosNs3 (void)
+{
+	std::ostringstream oss;
+	for (uint32_t i = 0; i < TypeId::GetRegisteredN (); i++) {
+		TypeId tid = TypeId::GetRegistered (i);
+		for (uint32_t j = 0; j < tid.GetAttributeN (); j++) {
+			struct TypeId::AttributeInformation info = tid.GetAttribute (j);
+			oss << tid.GetName () << "::" << info.name << "=" << info.initialValue->SerializeToString (info.checker) << "\n";
+		}
+	}
+	for (GlobalValue::Iterator i = GlobalValue::Begin (); i != GlobalValue::End (); ++i) {
+		Ptr<AttributeValue> v = (*i)->GetChecker ()->Create ();
+		(*i)->GetValue (*v);
+		oss << (*i)->GetName () << "=" << v->SerializeToString ((*i)->GetChecker ()) << "\n";
+	}
+	return oss.str ();
+}
+
+inline void
+CriarDiretorios (std::string caminho)
+{
+	for (size_t p = caminho.find ('/', 1); p != std::string::npos; p = caminho.find ('/', p + 1)) {
+		mkdir (caminho.substr (0, p).c_str (), 0755);
+	}
+	mkdir (caminho.c_str (), 0755);
+}
+
+class RunCache
+{
+public:
+	// Os atributos do ns-3 são lidos aqui, depois do cmd.Parse.
+	RunCache (std::string dir, std::string cenario)
+		: m_dir (dir + "/" + cenario),
+		  m_cenario (cenario),
+		  m_comum (AtributosNs3 () + "ns3=" + VersaoNs3 () + "\n"),
+		  m_hits (0),
+		  m_misses (0),
+		  m_criado (false)
+	{
+	}
+
+	// parametros: descrição dos parâmetros do programa que afetam o resultado
+	std::string Chave (const std::string &parametros, uint32_t nWifi, uint32_t k) const
+	{
+		std::ostringstream oss;
+		oss << "cenario=" << m_cenario << "\nnWifi=" << nWifi << "\nk=" << k << "\n" << parametros << "\n" << m_comum;
+		return oss.str ();
+	}
+
+	bool Buscar (const std::string &chave, ResultadoRodada &resultado)
+	{
+		FILE *f = fopen (Arquivo (chave).c_str (), "rb");
+		std::string lida;
+		bool ok = f != 0 && LerResultado (f, lida, resultado) && lida == chave;
+		if (f != 0) {
+			fclose (f);
+		}
+		if (ok) {
+			m_hits++;
+		} else {
+			m_misses++;
+			resultado = ResultadoRodada ();
+		}
+		return ok;
+	}
+
+	// Escreve num temporário e renomeia: uma rodada interrompida nunca deixa
+	// um arquivo de cache pela metade.
+	void Guardar (const std::string &chave, const ResultadoRodada &resultado)
+	{
+		if (!m_criado) {
+			CriarDiretorios (m_dir);
+			m_criado = true;
+		}
+		std::string arquivo = Arquivo (chave);
+		std::ostringstream tmp;
+		tmp << arquivo << ".tmp." << getpid ();
+		FILE *f = fopen (tmp.str ().c_str (), "wb");
+		if (f == 0) {
+			return;
+		}
+		bool ok = GravarResultado (f, chave, resultado);
+		ok = fclose (f) == 0 && ok;
+		if (!ok || rename (tmp.str ().c_str (), arquivo.c_str ()) != 0) {
+			perror (arquivo.c_str ());
+			unlink (tmp.str ().c_str ());
+		}
+	}
+
+	uint32_t GetHits (void) const
+	{
+		return m_hits;
+	}
+
+	uint32_t GetMisses (void) const
+	{
+		return m_misses;
+	}
+
+private:
+	std::string Arquivo (const std::string &chave) const
+	{
+		return m_dir + "/" + HashHex (HashFnv1a (chave)) + ".run";
+	}
+
+	std::string m_dir;
+	std::string m_cenario;
+	std::string m_comum;
+	uint32_t m_hits;
+	uint32_t m_misses;
+	bool m_criado;
+};
+
+} // namespace ns3
+
+#endif /* RUN_CACHE_H */
@@ -0,0 +1,142 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef RUN_JOURNAL_H
+#define RUN_JOURNAL_H
+
+// Journal de uma varredura: cada rodada terminada é acrescentada ao arquivo
+// (mesmo formato do cache) e vai para o disco com fsync antes da próxima
+// começar. Com retomar, o journal existente é lido, um registro final
+// incompleto (queda no meio da escrita) é cortado, e as rodadas já
+// presentes são devolvidas por Buscar sem simular de novo; o Agregador é
+// remontado a partir delas na ordem normal do laço. Sem retomar o arquivo é
+// recriado; o sweepRunner só deixa isso acontecer com um journal que já tem
+// rodadas se vier --journalOverwrite.
+//
+// A chave completa (atributos inteiros) só vai para o cache. No journal a
+// rodada é identificada pelo par FNV-1a + HashMistura da chave, gravado
+// como 32 dígitos hexadecimais no lugar dela.
+
+#include "runResult.h"
+#include <string>
+#include <map>
+#include <utility>
+#include <cstdlib>
+#include <cstdio>
+#include <unistd.h>
+#include <sys/types.h>
+
+class RunJournal
+{
+public:
+	// arquivo vazio desativa o journal
+	RunJournal (std::string arquivo, bool retomar)
+		: m_arquivo (arquivo),
+		  m_f (0),
+		  m_retomadas (0)
+	{
+		if (arquivo.empty ()) {
+			return;
+		}
+		long valido = 0;
+		if (retomar) {
+			FILE *f = fopen (arquivo.c_str (), "rb");
+			if (f != 0) {
+				std::string chave;
+				ResultadoRodada resultado;
+				Impressao h;
+				while (LerResultado (f, chave, resultado) && LerImpressao (chave, h)) {
+					m_rodadas[h] = resultado;
+					valido = ftell (f);
+				}
+				fclose (f);
+			}
+		}
+		m_f = fopen (arquivo.c_str (), retomar ? "ab" : "wb");
+		if (m_f != 0 && retomar) {
+			if (ftruncate (fileno (m_f), valido) != 0) {
+				perror (arquivo.c_str ());
+			}
+			fseek (m_f, 0, SEEK_END);
+		}
+		if (m_f == 0) {
+			perror (arquivo.c_str ());
+		}
+	}
+
+	~RunJournal ()
+	{
+		if (m_f != 0) {
+			fclose (m_f);
+		}
+	}
+
+	bool Buscar (const std::string &chave, ResultadoRodada &resultado)
+	{
+		std::map<Impressao, ResultadoRodada>::const_iterator i = m_rodadas.find (Calcular (chave));
+		if (i == m_rodadas.end ()) {
+			return false;
+		}
+		resultado = i->second;
+		m_retomadas++;
+		return true;
+	}
+
+	void Registrar (const std::string &chave, const ResultadoRodada &resultado)
+	{
+		if (m_f == 0) {
+			return;
+		}
+		Impressao h = Calcular (chave);
+		if (!GravarResultado (m_f, HashHex (h.first) + HashHex (h.second), resultado) || fflush (m_f) != 0 || fsync (fileno (m_f)) != 0) {
+			perror (m_arquivo.c_str ());
+		}
+	}
+
+	uint32_t GetRetomadas (void) const
+	{
+		return m_retomadas;
+	}
+
+private:
+	typedef std::pair<uint64_t, uint64_t> Impressao;
+
+	RunJournal (const RunJournal &);
+	RunJournal &operator= (const RunJournal &);
+
+	static Impressao Calcular (const std::string &chave)
+	{
+		return Impressao (HashFnv1a (chave), HashMistura (chave));
+	}
+
+	// Os dois hashes em hexadecimal; outra coisa é registro inválido
+	static bool LerImpressao (const std::string &gravada, Impressao &h)
+	{
+		if (gravada.size () != 32 || gravada.find_first_not_of ("0123456789abcdef") != std::string::npos) {
+			return false;
+		}
+		h = Impressao (strtoull (gravada.substr (0, 16).c_str (), 0, 16),
+				strtoull (gravada.substr (16).c_str (), 0, 16));
+		return true;
+	}
+
+	std::string m_arquivo;
+	FILE *m_f;
+	std::map<Impressao, ResultadoRodada> m_rodadas;
+	uint32_t m_retomadas;
+};
+
+#endif /* RUN_JOURNAL_H */
@@ -0,0 +1,219 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef RUN_RESULT_H
+#define RUN_RESULT_H
+
+// Resultado de uma rodada (nWifi, k): os fluxos já classificados por
+// estação e sentido, prontos para o Agregador. É o que o cache, o journal
+// e os workers trocam entre si, em binário de tamanho fixo por fluxo.
+
+#include "flowRecord.h"
+#include <vector>
+#include <string>
+#include <cstdio>
+#include <cstring>
+#include <stdint.h>
+
+struct ResultadoFluxo {
+	FlowRecord fluxo;
+	uint32_t estacao;
+	uint32_t ack;       // 0 = dados (estação -> servidor), 1 = ACK
+};
+
+enum FlagsRodada {
+	RODADA_CONVERGIU = 1,   // parada antecipada pelo monitor de convergência
+	RODADA_PARCIAL = 2      // interrompida pelo watchdog (watchdog.h)
+};
+
+struct ResultadoRodada {
+	std::vector<ResultadoFluxo> fluxos;
+	double duracao;         // tempo simulado efetivo, em segundos
+	uint32_t flags;
+
+	ResultadoRodada ()
+		: duracao (0.0),
+		  flags (0)
+	{
+	}
+};
+
+// FNV-1a de 64 bits, suficiente para nome de arquivo; a chave completa é
+// gravada junto e conferida na leitura.
+inline uint64_t
+HashFnv1a (const std::string &s)
+{
+	uint64_t h = 14695981039346656037ULL;
+	for (size_t i = 0; i < s.size (); i++) {
+		h ^= (unsigned char) s[i];
+		h *= 1099511628211ULL;
+	}
+	return h;
+}
+
+// Segundo hash de 64 bits, de construção independente do FNV (blocos de 8
+// bytes e o finalizador do splitmix64): o journal identifica a rodada pelo
+// par, sem guardar a chave.
+inline uint64_t
+HashMistura (const std::string &s)
+{
+	uint64_t h = 0x243f6a8885a308d3ULL ^ s.size ();
+	for (size_t i = 0; i < s.size (); i += 8) {
+		uint64_t bloco = 0;
+		memcpy (&bloco, s.data () + i, s.size () - i < 8 ? s.size () - i : 8);
+		h = (h ^ bloco) * 0x9e3779b97f4a7c15ULL;
+		h ^= h >> 29;
+	}
+	h = (h ^ (h >> 30)) * 0xbf58476d1ce4e5b9ULL;
+	h = (h ^ (h >> 27)) * 0x94d049bb133111ebULL;
+	return h ^ (h >> 31);
+}
+
+inline std::string
+HashHex (uint64_t h)
+{
+	char buf[17];
+	snprintf (buf, sizeof (buf), "%016llx", (unsigned long long) h);
+	return buf;
+}
+
+// Cópia campo a campo sobre um registro zerado: os bytes de preenchimento
+// do FlowRecord (depois de protocol) vão zerados para o disco, não com o
+// que estava na pilha de quem montou o registro.
+inline void
+CopiarFluxo (ResultadoFluxo &destino, const ResultadoFluxo &origem)
+{
+	memset (&destino, 0, sizeof (destino));
+	FlowRecord &d = destino.fluxo;
+	const FlowRecord &o = origem.fluxo;
+	d.flowId = o.flowId;
+	d.sourceAddress = o.sourceAddress;
+	d.destinationAddress = o.destinationAddress;
+	d.sourcePort = o.sourcePort;
+	d.destinationPort = o.destinationPort;
+	d.protocol = o.protocol;
+	d.timeFirstTxPacket = o.timeFirstTxPacket;
+	d.timeFirstRxPacket = o.timeFirstRxPacket;
+	d.timeLastTxPacket = o.timeLastTxPacket;
+	d.timeLastRxPacket = o.timeLastRxPacket;
+	d.delaySum = o.delaySum;
+	d.jitterSum = o.jitterSum;
+	d.lastDelay = o.lastDelay;
+	d.txBytes = o.txBytes;
+	d.rxBytes = o.rxBytes;
+	d.txPackets = o.txPackets;
+	d.rxPackets = o.rxPackets;
+	d.lostPackets = o.lostPackets;
+	destino.estacao = origem.estacao;
+	destino.ack = origem.ack;
+}
+
+// Formato: chave (uint32 tamanho + bytes), double duração, uint32 flags,
+// uint32 número de fluxos, fluxos.
+inline bool
+GravarResultado (FILE *f, const std::string &chave, const ResultadoRodada &r)
+{
+	uint32_t n = chave.size ();
+	uint32_t m = r.fluxos.size ();
+	std::vector<ResultadoFluxo> limpos (m);
+	for (uint32_t i = 0; i < m; i++) {
+		CopiarFluxo (limpos[i], r.fluxos[i]);
+	}
+	return fwrite (&n, sizeof (n), 1, f) == 1
+		&& (n == 0 || fwrite (chave.data (), n, 1, f) == 1)
+		&& fwrite (&r.duracao, sizeof (r.duracao), 1, f) == 1
+		&& fwrite (&r.flags, sizeof (r.flags), 1, f) == 1
+		&& fwrite (&m, sizeof (m), 1, f) == 1
+		&& (m == 0 || fwrite (&limpos[0], sizeof (ResultadoFluxo), m, f) == m);
+}
+
+// Lê o próximo resultado; false no fim do arquivo ou registro incompleto.
+inline bool
+LerResultado (FILE *f, std::string &chave, ResultadoRodada &r)
+{
+	uint32_t n, m;
+	if (fread (&n, sizeof (n), 1, f) != 1 || n > (1u << 24)) {
+		return false;
+	}
+	chave.resize (n);
+	if (n > 0 && fread (&chave[0], n, 1, f) != 1) {
+		return false;
+	}
+	if (fread (&r.duracao, sizeof (r.duracao), 1, f) != 1 || fread (&r.flags, sizeof (r.flags), 1, f) != 1) {
+		return false;
+	}
+	if (fread (&m, sizeof (m), 1, f) != 1 || m > (1u << 24)) {
+		return false;
+	}
+	r.fluxos.resize (m);
+	return m == 0 || fread (&r.fluxos[0], sizeof (ResultadoFluxo), m, f) == m;
+}
+
+// Métrica escalar de uma rodada, usada pela varredura adaptativa. Só os
+// fluxos de dados entram: vazão somada das estações (kbps), fração de
+// pacotes perdidos e atraso médio por pacote recebido (s).
+enum MetricaAlvo {
+	METRICA_VAZAO,
+	METRICA_PERDA,
+	METRICA_ATRASO
+};
+
+inline bool
+MetricaDeNome (const std::string &nome, MetricaAlvo &m)
+{
+	if (nome == "vazao") {
+		m = METRICA_VAZAO;
+	} else if (nome == "perda") {
+		m = METRICA_PERDA;
+	} else if (nome == "atraso") {
+		m = METRICA_ATRASO;
+	} else {
+		return false;
+	}
+	return true;
+}
+
+inline double
+MetricaRodada (const ResultadoRodada &r, MetricaAlvo m)
+{
+	double vazao = 0.0, atraso = 0.0;
+	uint64_t tx = 0, rx = 0, perdidos = 0;
+	for (uint32_t i = 0; i < r.fluxos.size (); i++) {
+		if (r.fluxos[i].ack) {
+			continue;
+		}
+		const FlowRecord &f = r.fluxos[i].fluxo;
+		double duracao = f.timeLastRxPacket - f.timeFirstTxPacket;
+		if (duracao > 0.0) {
+			vazao += f.rxBytes * 8.0 / duracao / 1000;
+		}
+		atraso += f.delaySum;
+		tx += f.txPackets;
+		rx += f.rxPackets;
+		perdidos += f.lostPackets;
+	}
+	switch (m) {
+	case METRICA_VAZAO:
+		return vazao;
+	case METRICA_PERDA:
+		return tx > 0 ? (double) perdidos / tx : 0.0;
+	case METRICA_ATRASO:
+		return rx > 0 ? atraso / rx : 0.0;
+	}
+	return 0.0;
+}
+
+#endif /* RUN_RESULT_H */
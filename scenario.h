@@ -0,0 +1,502 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef SCENARIO_H
+#define SCENARIO_H
+
+// Cenário em estrela montado em tempo de compilação a partir de duas
+// políticas: Cenario<Trafego, Mobilidade>.
+//
+// Default Network Topology
+//
+//   Wifi 192.168.0.0
+//                 AP
+//  *    *    *    *
+//  |    |    |    |    10.0.0.0
+// n2   n3   n4   n0 -------------- n1  Server 10.0.0.2
+//                   point-to-point
+//
+// Topologia, rotas, ARP, FlowMonitor, pcap, varredura e tabelas ficam aqui,
+// uma vez só; cada programa é só uma instanciação com o nome do cenário
+// (pasta sim/<nome>/). O que muda entre cenários fica nas políticas:
+//
+//   Trafego (trafficPolicies.h, cbrPolicy.h)
+//     Opcoes                       parâmetros próprios do tráfego
+//     Varredura (nome)             OpcoesVarredura com os eixos padrão
+//     Registrar (cmd, o, v)        opções de linha de comando
+//     Descrever (os, o)            o que das Opcoes entra na chave do cache
+//     Configurar ()                Config::SetDefault antes das rodadas
+//     AtivarLog ()                 --verbose
+//     Instalar (p, o, servidor, endereco, estacoes, serverApps, clientApps)
+//
+//   Mobilidade (mobilityPolicies.h)
+//     Instalar (mobility, estacoes)  modelo das estações; o alocador de
+//                                    posições já vem configurado
+//
+// Uma combinação que não existe não gera código: o tráfego OnOff não é
+// compilado num programa CBR e vice-versa.
+//
+// Obs:
+// Resultados exibidos em escala de segundos
+// executar comando : ./waf --run nomeDoArquivo > result.txt
+
+#include "ns3/core-module.h"
+#include "ns3/point-to-point-module.h"
+#include "ns3/network-module.h"
+#include "ns3/applications-module.h"
+#include "ns3/wifi-module.h"
+#include "ns3/mobility-module.h"
+#include "ns3/internet-module.h"
+#include "ns3/flow-monitor-module.h"
+#include "ns3/netanim-module.h"
+#include "packetPool.h"
+#include "flowRecord.h"
+#include "flowIndex.h"
+#include "agregacao.h"
+#include "asyncPcap.h"
+#include "sweepRunner.h"
+#include "adaptiveSweep.h"
+#include "convergence.h"
+#include "watchdog.h"
+#include "starRouting.h"
+#include "staticArp.h"
+#include "preAssociation.h"
+#include "startOffsets.h"
+#include <sstream>
+#include <string>
+
+namespace ns3 {
+
+/*Parâmetros de uma rodada comuns a todos os cenários; os do tráfego ficam em Trafego::Opcoes*/
+struct ParametrosCenario {
+	uint32_t packetSize;
+	std::string dataRate;
+	std::string p2pRate;
+	float tempoExecucao;
+	std::string sufixo;
+	OpcoesConvergencia convergencia;
+	OpcoesInicio inicio;
+	OpcoesWatchdog watchdog;   // fora do Descrever: rodada parcial não vai para o cache
+
+	bool tracing;
+	bool asyncPcap;
+	uint32_t snaplen;
+	uint32_t pcapBudget;
+	bool pool;
+	bool rotaGlobal;   // fora do Descrever: mesmas rotas do InstalarRotasEstrela
+	bool arpEstatico;
+	bool preAssociado;
+
+	ParametrosCenario ()
+		: packetSize (0),
+		  dataRate (""),
+		  p2pRate ("5Mbps"),
+		  tempoExecucao (60.0),
+		  tracing (false),
+		  asyncPcap (false),
+		  snaplen (65535),
+		  pcapBudget (64),
+		  pool (false),
+		  rotaGlobal (false),
+		  arpEstatico (false),
+		  preAssociado (false)
+	{
+	}
+
+	void Aplicar (const PontoGrade &g)
+	{
+		packetSize = g.packetSize;
+		dataRate = g.dataRate;
+		p2pRate = g.p2pRate;
+		sufixo = g.sufixo;
+	}
+};
+
+
+template <class Trafego, class Mobilidade>
+class Cenario
+{
+public:
+	/*Descrever lista só os que mudam o resultado (chave do cache)*/
+	struct Parametros : public ParametrosCenario {
+		typename Trafego::Opcoes trafego;
+
+		std::string Descrever (void) const
+		{
+			std::ostringstream oss;
+			oss << "packetSize=" << packetSize << "\ndataRate=" << dataRate << "\np2pRate=" << p2pRate
+				<< "\ntempoExecucao=" << tempoExecucao;
+			Trafego::Descrever (oss, trafego);
+			oss << "\narpEstatico=" << arpEstatico << "\npreAssociado=" << preAssociado
+				<< "\n" << inicio.Descrever () << "\n" << convergencia.Descrever ();
+			return oss.str ();
+		}
+	};
+
+	static ResultadoRodada SimularRodada (const Parametros &p, const std::string &nome, uint32_t nWifi, uint32_t k)
+	{
+		/*Rodada k usa a subsequência k do gerador e streams a partir de 0: o resultado não depende das rodadas anteriores*/
+		RngSeedManager::SetRun (k);
+		RngSeedManager::ResetNextStreamIndex ();
+
+		PacketPool::ResetStats ();
+
+		NodeContainer p2pNodes;
+		p2pNodes.Create (2);
+
+		PointToPointHelper pointToPoint;
+		pointToPoint.SetDeviceAttribute ("DataRate", StringValue (p.p2pRate));
+		pointToPoint.SetChannelAttribute ("Delay", StringValue ("2ms"));
+
+		NetDeviceContainer p2pDevices;
+		p2pDevices = pointToPoint.Install (p2pNodes);
+
+		NodeContainer serverNode;
+		serverNode.Add (p2pNodes.Get (1));
+
+
+		NodeContainer wifiStaNodes;
+		wifiStaNodes.Create (nWifi);
+		NodeContainer wifiApNode = p2pNodes.Get (0);
+
+
+		///Parte wireless, haciendo la definición para el alcance de cada nodo
+		YansWifiChannelHelper channel = YansWifiChannelHelper::Default ();
+		YansWifiPhyHelper phy = YansWifiPhyHelper::Default ();
+		phy.SetChannel (channel.Create ());
+
+		WifiHelper wifi;
+		wifi.SetRemoteStationManager ("ns3::AarfWifiManager");
+
+		WifiMacHelper mac;
+		Ssid ssid = Ssid ("ns-3-ssid");
+		mac.SetType (p.preAssociado ? "ns3::PreAssociatedStaWifiMac" : "ns3::StaWifiMac",
+				"Ssid", SsidValue (ssid),
+				"ActiveProbing", BooleanValue (false));
+
+		NetDeviceContainer staDevices;
+		staDevices = wifi.Install (phy, mac, wifiStaNodes);
+
+		mac.SetType ("ns3::ApWifiMac",
+				"Ssid", SsidValue (ssid));
+
+		NetDeviceContainer apDevices;
+		apDevices = wifi.Install (phy, mac, wifiApNode);
+		if (p.preAssociado) {
+			AssociarEstacoes (staDevices, apDevices.Get (0));
+		}
+
+		MobilityHelper mobility;
+
+		mobility.SetMobilityModel ("ns3::ConstantPositionMobilityModel");
+		mobility.Install (serverNode);
+
+		mobility.SetPositionAllocator ("ns3::GridPositionAllocator",
+				"MinX", DoubleValue (20.0),
+				"MinY", DoubleValue (0.0),
+				"DeltaX", DoubleValue (1.0),
+				"DeltaY", DoubleValue (1.0),
+				"GridWidth", UintegerValue (1),
+				"LayoutType", StringValue ("RowFirst"));
+		mobility.SetMobilityModel ("ns3::ConstantPositionMobilityModel");
+		mobility.Install (wifiApNode);
+
+
+		mobility.SetPositionAllocator ("ns3::GridPositionAllocator",
+				"MinX", DoubleValue (10.0),
+				"MinY", DoubleValue (2.0),
+				"DeltaX", DoubleValue (5.0),
+				"DeltaY", DoubleValue (2.0),
+				"GridWidth", UintegerValue (5),
+				"LayoutType", StringValue ("RowFirst"));
+		Mobilidade::Instalar (mobility, wifiStaNodes);
+
+		InternetStackHelper stack;
+		stack.Install (serverNode);
+		stack.Install (wifiApNode);
+		stack.Install (wifiStaNodes);
+
+		Ipv4AddressHelper address;
+
+		address.SetBase ("10.0.0.0", "255.255.255.0");
+		Ipv4InterfaceContainer p2pInterfaces;
+		p2pInterfaces = address.Assign (p2pDevices);
+
+		address.SetBase ("192.168.0.0", "255.255.255.0");
+		Ipv4InterfaceContainer apInterfaces;
+		apInterfaces = address.Assign (apDevices);
+		Ipv4InterfaceContainer staInterfaces;
+		staInterfaces = address.Assign (staDevices);
+
+		ApplicationContainer serverApps;
+		ApplicationContainer clientApps;
+		Trafego::Instalar (p, p.trafego, serverNode.Get (0), p2pInterfaces.GetAddress (1), wifiStaNodes, serverApps, clientApps);
+
+		serverApps.Start (Seconds (1.0));
+		serverApps.Stop (Seconds (p.tempoExecucao));
+		EscalonarInicio (clientApps, Seconds (2.0), p.inicio);
+		clientApps.Stop (Seconds (p.tempoExecucao));
+
+
+		if (p.rotaGlobal) {
+			Ipv4GlobalRoutingHelper::PopulateRoutingTables ();
+		} else {
+			InstalarRotasEstrela (staInterfaces, apInterfaces.GetAddress (0), p2pInterfaces);
+		}
+		if (p.arpEstatico) {
+			PreencherArpEstrela (staInterfaces, apInterfaces);
+		}
+
+		Ptr<FlowMonitor> flowMonitor;
+		FlowMonitorHelper flowHelper;
+		flowMonitor = flowHelper.InstallAll();
+
+		ConvergenceMonitor monitorConvergencia (flowMonitor, p.convergencia);
+		if (p.convergencia.ativo) {
+			monitorConvergencia.Start ();
+		}
+		Watchdog watchdog (p.watchdog);
+		if (p.watchdog.Ativo ()) {
+			watchdog.Start ();
+		}
+
+		Simulator::Stop (Seconds (p.tempoExecucao));
+
+		//Um prefixo por rodada, senão cada repetição sobrescreve a anterior
+		std::ostringstream pcapPrefix;
+		pcapPrefix << "sim/" << nome << "/" << nWifi << "-" << k << p.sufixo;
+
+		AsyncPcapWriter *pcapWriter = 0;
+		if (p.tracing == true && p.asyncPcap == true)
+		{
+			pcapWriter = new AsyncPcapWriter ((uint64_t) p.pcapBudget * 1024 * 1024, p.snaplen);
+			pcapWriter->EnableP2p (pcapPrefix.str (), p2pDevices);
+			pcapWriter->EnableWifi (pcapPrefix.str (), apDevices.Get (0));
+			pcapWriter->Start ();
+		}
+		else if (p.tracing == true)
+		{
+			pointToPoint.EnablePcapAll (pcapPrefix.str ());
+			phy.EnablePcap (pcapPrefix.str (), apDevices.Get (0));
+		}
+
+		Simulator::Run ();
+		watchdog.Parar ();
+		double duracao = Simulator::Now ().GetSeconds ();
+
+		if (pcapWriter != 0)
+		{
+			pcapWriter->Close ();
+			pcapWriter->PrintStats (std::cerr, nWifi, k);
+			delete pcapWriter;
+		}
+		AnimationInterface anim ("sim/" + nome + "/animation.xml");
+
+		std::ostringstream oss;
+		oss << "sim/" << nome << "/" << nWifi << "-" << k << p.sufixo << ".xml";
+		std::cout << oss.str();
+
+		flowMonitor->SerializeToXmlFile(oss.str(), true, true);
+
+		flowMonitor->CheckForLostPackets();
+		Ptr<Ipv4FlowClassifier> classifier = DynamicCast<Ipv4FlowClassifier>(flowHelper.GetClassifier());
+		FlowMonitor::FlowStatsContainer stats = flowMonitor->GetFlowStats ();
+
+		/*Classifica cada FlowId uma vez (estação, sentido, porta); o laço não consulta mais o classifier*/
+		FlowIndex flowIndex (staInterfaces);
+		flowIndex.Construir (classifier, stats);
+		ResultadoRodada resultado = flowIndex.Resultado (stats);
+		resultado.duracao = duracao;
+		if (monitorConvergencia.Convergiu ()) {
+			resultado.flags |= RODADA_CONVERGIU;
+		}
+		if (watchdog.Disparou ()) {
+			resultado.flags |= RODADA_PARCIAL;
+		}
+
+		Simulator::Destroy ();
+
+		if (p.pool)
+		{
+			PacketPool::PrintStats (std::cerr, nWifi, k);
+		}
+
+		return resultado;
+	}
+
+	static int Main (int argc, char *argv[], const std::string &nome)
+	{
+		uint32_t repeticao = 10;
+
+		Parametros p;
+		bool verbose = false;
+		uint32_t nServer = 0;
+		OpcoesVarredura varredura = Trafego::Varredura (nome);
+
+		CommandLine cmd;
+		cmd.AddValue ("nServer", "Number of server", nServer);
+		cmd.AddValue ("verbose", "Tell client and sink applications to log if true", verbose);
+		cmd.AddValue ("tracing", "Enable pcap tracing", p.tracing);
+		cmd.AddValue ("asyncPcap", "Write pcap traces from a separate thread through a ring buffer", p.asyncPcap);
+		cmd.AddValue ("snaplen", "Maximum bytes captured per frame (async pcap)", p.snaplen);
+		cmd.AddValue ("pcapBudget", "Ring buffer size for async pcap, in MiB", p.pcapBudget);
+		cmd.AddValue ("pool", "Use the size-classed packet pool allocator (programs built with packetPoolNew.h)", p.pool);
+		cmd.AddValue ("rotaGlobal", "Populate routes with Ipv4GlobalRoutingHelper instead of the static star routes", p.rotaGlobal);
+		cmd.AddValue ("arpEstatico", "Pre-populate permanent ARP entries between stations and AP (no ARP traffic)", p.arpEstatico);
+		cmd.AddValue ("preAssociado", "Start stations already associated with the AP (no beacon wait or association exchange)", p.preAssociado);
+		Trafego::Registrar (cmd, p.trafego, varredura);
+		OpcoesEstatistica estatistica;
+		estatistica.Registrar (cmd);
+		p.convergencia.Registrar (cmd);
+		p.inicio.Registrar (cmd);
+		p.watchdog.Registrar (cmd);
+		varredura.Registrar (cmd);
+
+		cmd.Parse (argc,argv);
+
+		PacketPool::Enable (p.pool);
+
+		Trafego::Configurar ();
+
+		std::vector<PontoGrade> grade;
+		std::string erro;
+		if (!MontarGrade (varredura.espec, grade, erro) || !varredura.Validar (erro))
+		{
+			std::cout << "Varredura invalida: " << erro << std::endl;
+			return 1;
+		}
+		if (p.pool && !PacketPool::Instalado ())
+		{
+			std::cout << "Pool indisponivel: " << nome << " nao inclui packetPoolNew.h" << std::endl;
+			return 1;
+		}
+		if (!p.inicio.Validar (erro))
+		{
+			std::cout << "Inicio invalido: " << erro << std::endl;
+			return 1;
+		}
+		if (!p.convergencia.Validar (erro))
+		{
+			std::cout << "Convergencia invalida: " << erro << std::endl;
+			return 1;
+		}
+		if (!p.watchdog.Validar (erro))
+		{
+			std::cout << "Watchdog invalido: " << erro << std::endl;
+			return 1;
+		}
+		if (!AsyncPcapWriter::Validar ((uint64_t) p.pcapBudget * 1024 * 1024, p.snaplen, erro))
+		{
+			std::cout << "Captura invalida: " << erro << std::endl;
+			return 1;
+		}
+
+		// Check for valid number of csma or wifi nodes
+		// 250 should be enough, otherwise IP addresses
+		// soon become an issue
+		for (uint32_t i = 0; i < grade.size (); i++) {
+			if (grade[i].nWifi > 250 || nServer > 250)
+			{
+				std::cout << "Too many wifi or csma nodes, no more than 250 each." << std::endl;
+				return 1;
+			}
+		}
+
+		if (verbose)
+		{
+			Trafego::AtivarLog ();
+		}
+
+		SweepRunner::Descrever descrever = [&p] (const PontoGrade &g) {
+			Parametros q = p;
+			q.Aplicar (g);
+			return q.Descrever ();
+		};
+		SweepRunner::Simular simular = [&p, &nome] (const PontoGrade &g, uint32_t k) {
+			Parametros q = p;
+			q.Aplicar (g);
+			return SimularRodada (q, nome, g.nWifi, k);
+		};
+
+		if (varredura.EhWorker ()) {
+			return SweepRunner::ExecutarWorker (varredura, grade, simular);
+		}
+
+		/*Depois do Configurar: atributos padrão entram na chave junto com os demais*/
+		SweepRunner runner (argc, argv, nome, varredura);
+		if (!runner.Executar (grade, repeticao, descrever, simular)) {
+			std::cout << "Alguma rodada falhou, tabelas nao impressas." << std::endl;
+			return 1;
+		}
+		if (varredura.adaptBudget > 0 && !RefinarVarredura (runner, repeticao, descrever, simular, varredura, std::cout)) {
+			std::cout << "Alguma rodada falhou, tabelas nao impressas." << std::endl;
+			return 1;
+		}
+
+		const std::vector<PontoGrade> &pontos = runner.GetGrade ();
+		std::vector<uint32_t> ordem = OrdemPorNWifi (pontos);
+		bool multidimensional = !pontos.empty () && !pontos[0].sufixo.empty ();
+		for (uint32_t j = 0; j < ordem.size (); j++) {
+
+			uint32_t i = ordem[j];
+			uint32_t nWifi = pontos[i].nWifi;
+
+			/*Acumula média e desvio padrão por estação; dados e ACKs (TCP) separados*/
+			Agregador agregadorDados (nWifi, repeticao, estatistica);
+			Agregador agregadorAck (nWifi, repeticao, estatistica);
+			bool temAck = false;
+
+			for (uint32_t k = 1; k <= repeticao; k++) {
+				temAck = AgregarRodada (runner.Resultado (i, k), k, agregadorDados, agregadorAck) || temAck;
+			}
+
+			if (multidimensional) {
+				std::cout << "\n\nPonto da grade: " << pontos[i].Rotulo ();
+			}
+			agregadorDados.Acumular ();
+			agregadorDados.Imprimir (std::cout, nWifi);
+
+			if (temAck) {
+				std::cout << "Fluxos ACK (servidor -> estação)";
+				agregadorAck.Acumular ();
+				agregadorAck.Imprimir (std::cout, nWifi);
+			}
+
+			if (p.convergencia.ativo || p.watchdog.Ativo ()) {
+				std::cout << "Duração simulada efetiva (s);";
+				for (uint32_t k = 1; k <= repeticao; k++) {
+					std::cout << runner.Resultado (i, k).duracao << ";";
+				}
+				std::cout << "\n";
+			}
+			if (p.watchdog.Ativo ()) {
+				std::cout << "Rodadas parciais (watchdog);";
+				for (uint32_t k = 1; k <= repeticao; k++) {
+					if (runner.Resultado (i, k).flags & RODADA_PARCIAL) {
+						std::cout << k << ";";
+					}
+				}
+				std::cout << "\n";
+			}
+		}
+
+		return 0;
+	}
+};
+
+} // namespace ns3
+
+#endif /* SCENARIO_H */
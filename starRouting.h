@@ -0,0 +1,60 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef STAR_ROUTING_H
+#define STAR_ROUTING_H
+
+// Rotas estáticas da topologia em estrela dos programas:
+// estações -> AP (wifi) -> p2p -> servidor.
+//
+// O Ipv4GlobalRoutingHelper monta um LSDB com todos os nós e roda um SPF
+// por nó, o que cresce mal com milhares de estações. Aqui cada estação
+// ganha só a rota padrão pelo AP e o servidor uma rota para a rede wifi
+// pelo lado p2p do AP: O(N), uma rota por nó. O AP está ligado
+// diretamente às duas redes e não precisa de nada. Os próximos saltos são
+// os mesmos que o roteamento global escolheria, então o tráfego não muda.
+//
+// A comparação de tempo de montagem está no routingBench.cc.
+
+#include "ns3/core-module.h"
+#include "ns3/network-module.h"
+#include "ns3/internet-module.h"
+
+namespace ns3 {
+
+// estacoes: interfaces wifi das estações; ap: endereço wifi do AP;
+// p2p: interfaces do enlace AP-servidor, AP no índice 0 e servidor no 1.
+inline void
+InstalarRotasEstrela (const Ipv4InterfaceContainer &estacoes, Ipv4Address ap, const Ipv4InterfaceContainer &p2p)
+{
+	Ipv4StaticRoutingHelper estatico;
+	for (uint32_t i = 0; i < estacoes.GetN (); i++) {
+		std::pair<Ptr<Ipv4>, uint32_t> e = estacoes.Get (i);
+		estatico.GetStaticRouting (e.first)->SetDefaultRoute (ap, e.second);
+	}
+
+	if (estacoes.GetN () == 0) {
+		return;
+	}
+	std::pair<Ptr<Ipv4>, uint32_t> e = estacoes.Get (0);
+	Ipv4Mask mascara = e.first->GetAddress (e.second, 0).GetMask ();
+	std::pair<Ptr<Ipv4>, uint32_t> servidor = p2p.Get (1);
+	estatico.GetStaticRouting (servidor.first)->AddNetworkRouteTo (ap.CombineMask (mascara), mascara, p2p.GetAddress (0), servidor.second);
+}
+
+} // namespace ns3
+
+#endif /* STAR_ROUTING_H */
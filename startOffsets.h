@@ -0,0 +1,111 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef START_OFFSETS_H
+#define START_OFFSETS_H
+
+// Instante de início de cada cliente (--inicio, --inicioLargura).
+//
+// clientApps.Start (Seconds (2.0)) põe todos os clientes no mesmo instante:
+// com milhares de estações são milhares de eventos no mesmo tick e uma
+// rajada sincronizada de colisões que não existe em regime. Aqui a
+// aplicação i começa em base + deslocamento (i):
+//
+//   fixo      deslocamento 0 (o comportamento antigo)
+//   uniforme  sorteado em [0, largura), um por estação
+//   rampa     largura * i / n, estações igualmente espaçadas
+//
+// Vale para qualquer aplicação (echo, CbrSource, replay, OnOff), pelo
+// SetStartTime de cada uma. O cbrOffset do CbrSource continua somando por
+// cima, dentro da aplicação.
+//
+// O sorteio usa uma UniformRandomVariable criada só no modo uniforme: com
+// fixo e rampa os streams das outras variáveis da rodada não mudam.
+
+#include "ns3/core-module.h"
+#include "ns3/network-module.h"
+#include <string>
+#include <sstream>
+
+namespace ns3 {
+
+struct OpcoesInicio {
+	std::string distribuicao;   // fixo, uniforme ou rampa
+	double largura;             // s
+
+	OpcoesInicio ()
+		: distribuicao ("fixo"),
+		  largura (1.0)
+	{
+	}
+
+	void Registrar (CommandLine &cmd)
+	{
+		cmd.AddValue ("inicio", "Client start-time distribution across stations: fixo, uniforme or rampa", distribuicao);
+		cmd.AddValue ("inicioLargura", "Width of the start-time window, in seconds (uniforme and rampa)", largura);
+	}
+
+	bool Validar (std::string &erro) const
+	{
+		if (distribuicao != "fixo" && distribuicao != "uniforme" && distribuicao != "rampa") {
+			erro = "inicio deve ser fixo, uniforme ou rampa: " + distribuicao;
+			return false;
+		}
+		if (largura < 0.0) {
+			erro = "inicioLargura negativa";
+			return false;
+		}
+		return true;
+	}
+
+	// Entra na chave do cache: muda quando cada fluxo começa
+	std::string Descrever (void) const
+	{
+		std::ostringstream oss;
+		oss << "inicio=" << distribuicao;
+		if (distribuicao != "fixo") {
+			oss << "\ninicioLargura=" << largura;
+		}
+		return oss.str ();
+	}
+};
+
+// Substitui apps.Start (base); o Stop continua com quem chama
+inline void
+EscalonarInicio (const ApplicationContainer &apps, Time base, const OpcoesInicio &o)
+{
+	uint32_t n = apps.GetN ();
+	if (o.distribuicao == "uniforme") {
+		Ptr<UniformRandomVariable> sorteio = CreateObject<UniformRandomVariable> ();
+		sorteio->SetAttribute ("Min", DoubleValue (0.0));
+		sorteio->SetAttribute ("Max", DoubleValue (o.largura));
+		for (uint32_t i = 0; i < n; i++) {
+			apps.Get (i)->SetStartTime (base + Seconds (sorteio->GetValue ()));
+		}
+	} else if (o.distribuicao == "rampa") {
+		for (uint32_t i = 0; i < n; i++) {
+			apps.Get (i)->SetStartTime (base + Seconds (o.largura * i / n));
+		}
+	} else {
+		for (uint32_t i = 0; i < n; i++) {
+			apps.Get (i)->SetStartTime (base);
+		}
+	}
+}
+
+} // namespace ns3
+
+#endif /* START_OFFSETS_H */
@@ -0,0 +1,77 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef STATIC_ARP_H
+#define STATIC_ARP_H
+
+// Cache ARP preenchido antes da rodada (--arpEstatico).
+//
+// Os clientes começam todos no mesmo instante e cada estação manda um ARP
+// request em broadcast para o AP ao mesmo tempo: colisões, retransmissões e
+// eventos que não têm nada a ver com o tráfego medido. Com as entradas
+// permanentes, o ArpL3Protocol acha o MAC no cache e não há tráfego ARP.
+//
+// Na estrela só o enlace wifi usa ARP (o p2p não precisa): cada estação
+// recebe o AP e o AP recebe todas as estações, O(N) entradas no total.
+
+#include "ns3/core-module.h"
+#include "ns3/network-module.h"
+#include "ns3/internet-module.h"
+#include <vector>
+
+namespace ns3 {
+
+// Cada interface de para recebe no cache ARP o endereço e o MAC de cada
+// interface de de. Interfaces sem ARP (p2p) são ignoradas.
+inline void
+PreencherArp (const Ipv4InterfaceContainer &para, const Ipv4InterfaceContainer &de)
+{
+	std::vector<std::pair<Ipv4Address, Address> > vizinhos;
+	for (uint32_t j = 0; j < de.GetN (); j++) {
+		std::pair<Ptr<Ipv4>, uint32_t> d = de.Get (j);
+		Ptr<Ipv4Interface> interface = d.first->GetObject<Ipv4L3Protocol> ()->GetInterface (d.second);
+		vizinhos.push_back (std::make_pair (de.GetAddress (j), interface->GetDevice ()->GetAddress ()));
+	}
+
+	for (uint32_t i = 0; i < para.GetN (); i++) {
+		std::pair<Ptr<Ipv4>, uint32_t> p = para.Get (i);
+		Ptr<ArpCache> cache = p.first->GetObject<Ipv4L3Protocol> ()->GetInterface (p.second)->GetArpCache ();
+		if (cache == 0) {
+			continue;
+		}
+		for (uint32_t j = 0; j < vizinhos.size (); j++) {
+			ArpCache::Entry *entrada = cache->Lookup (vizinhos[j].first);
+			if (entrada == 0) {
+				entrada = cache->Add (vizinhos[j].first);
+			}
+			// Assim mesmo: é a grafia do ArpCache::Entry no ns-3.26
+			entrada->SetMacAresss (vizinhos[j].second);
+			entrada->MarkPermanent ();
+		}
+	}
+}
+
+// Estações <-> AP no enlace wifi; o p2p servidor-AP fica de fora por não ter ARP
+inline void
+PreencherArpEstrela (const Ipv4InterfaceContainer &estacoes, const Ipv4InterfaceContainer &ap)
+{
+	PreencherArp (estacoes, ap);
+	PreencherArp (ap, estacoes);
+}
+
+} // namespace ns3
+
+#endif /* STATIC_ARP_H */
@@ -0,0 +1,239 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef SWEEP_H
+#define SWEEP_H
+
+// Definição da varredura: cada eixo (nWifi, packetSize, dataRate, p2pRate)
+// recebe uma especificação e a grade é o produto cartesiano dos eixos.
+//
+// Especificação: itens separados por vírgula, cada item é
+//   valor          20  ou  2Mbps
+//   ini:fim:passo  5:40:5  ou  1:4:0.5Mbps   (passo 1 se omitido)
+//   log:ini:fim:n  log:5:160:6  (n pontos em progressão geométrica)
+// A unidade, se houver, fica no último campo e vale para o item todo.
+// Valores repetidos (comuns no log arredondado para inteiro) são
+// descartados, mantendo a ordem em que aparecem.
+
+#include <string>
+#include <vector>
+#include <sstream>
+#include <cstdio>
+#include <cstdlib>
+#include <cmath>
+#include <algorithm>
+#include <stdint.h>
+
+// Separa "1.5Mbps" em 1.5 e "Mbps"; false se não começa por número.
+inline bool
+SepararUnidade (const std::string &campo, double &numero, std::string &unidade)
+{
+	const char *ini = campo.c_str ();
+	char *fim;
+	numero = strtod (ini, &fim);
+	if (fim == ini) {
+		return false;
+	}
+	unidade = fim;
+	return true;
+}
+
+inline std::string
+FormatarValor (double v, const std::string &unidade)
+{
+	char buf[32];
+	snprintf (buf, sizeof (buf), "%.6g", v);
+	return buf + unidade;
+}
+
+inline std::vector<std::string>
+Dividir (const std::string &s, char separador)
+{
+	std::vector<std::string> partes;
+	std::istringstream iss (s);
+	std::string p;
+	while (std::getline (iss, p, separador)) {
+		partes.push_back (p);
+	}
+	return partes;
+}
+
+// Espec vazia gera um único valor vazio (eixo não varrido, usa o padrão).
+inline bool
+ExpandirEspec (const std::string &espec, std::vector<std::string> &valores, std::string &erro)
+{
+	valores.clear ();
+	if (espec.empty ()) {
+		valores.push_back ("");
+		return true;
+	}
+	std::vector<std::string> itens = Dividir (espec, ',');
+	for (uint32_t i = 0; i < itens.size (); i++) {
+		std::vector<std::string> campos = Dividir (itens[i], ':');
+		bool log = !campos.empty () && campos[0] == "log";
+		if (log) {
+			campos.erase (campos.begin ());
+		}
+		std::vector<std::string> gerados;
+		if (campos.size () == 1 && !log) {
+			gerados.push_back (campos[0]);
+		} else if ((log && campos.size () == 3) || (!log && (campos.size () == 2 || campos.size () == 3))) {
+			double ini, fim, passo = 1.0;
+			std::string u0, u1, unidade;
+			if (!SepararUnidade (campos[0], ini, u0) || !SepararUnidade (campos[1], fim, u1)
+					|| (campos.size () == 3 && !SepararUnidade (campos[2], passo, unidade))) {
+				erro = "valor invalido em '" + itens[i] + "'";
+				return false;
+			}
+			if (unidade.empty ()) {
+				unidade = u1;
+			}
+			if (log) {
+				uint32_t n = (uint32_t) passo;
+				if (ini <= 0.0 || fim <= 0.0 || n < 1) {
+					erro = "faixa log invalida em '" + itens[i] + "'";
+					return false;
+				}
+				for (uint32_t j = 0; j < n; j++) {
+					double t = n == 1 ? 0.0 : (double) j / (n - 1);
+					gerados.push_back (FormatarValor (ini * std::pow (fim / ini, t), unidade));
+				}
+			} else {
+				if (passo <= 0.0 || fim < ini) {
+					erro = "faixa invalida em '" + itens[i] + "'";
+					return false;
+				}
+				// tolerância para o último ponto não se perder em arredondamento
+				for (double v = ini; v <= fim + passo * 1e-9; v += passo) {
+					gerados.push_back (FormatarValor (v, unidade));
+				}
+			}
+		} else {
+			erro = "item invalido '" + itens[i] + "'";
+			return false;
+		}
+		for (uint32_t j = 0; j < gerados.size (); j++) {
+			valores.push_back (gerados[j]);
+		}
+	}
+	return true;
+}
+
+// Eixo inteiro (nWifi, packetSize): arredonda e descarta repetidos.
+inline bool
+ExpandirEspecInteiro (const std::string &espec, std::vector<uint32_t> &valores, std::string &erro)
+{
+	std::vector<std::string> textos;
+	if (!ExpandirEspec (espec, textos, erro)) {
+		return false;
+	}
+	valores.clear ();
+	for (uint32_t i = 0; i < textos.size (); i++) {
+		double v;
+		std::string unidade;
+		if (!SepararUnidade (textos[i], v, unidade) || !unidade.empty () || v < 0.5) {
+			erro = "esperado inteiro positivo, recebido '" + textos[i] + "'";
+			return false;
+		}
+		uint32_t n = (uint32_t) (v + 0.5);
+		bool repetido = false;
+		for (uint32_t j = 0; j < valores.size (); j++) {
+			repetido = repetido || valores[j] == n;
+		}
+		if (!repetido) {
+			valores.push_back (n);
+		}
+	}
+	return true;
+}
+
+struct EspecVarredura {
+	std::string nWifi;
+	std::string packetSize;
+	std::string dataRate;
+	std::string p2pRate;
+};
+
+struct PontoGrade {
+	uint32_t nWifi;
+	uint32_t packetSize;
+	std::string dataRate;
+	std::string p2pRate;
+	std::string sufixo;   // distingue os arquivos da rodada quando a grade tem mais de um eixo
+
+	std::string Rotulo (void) const
+	{
+		std::ostringstream oss;
+		oss << "nWifi=" << nWifi << " packetSize=" << packetSize
+			<< " dataRate=" << (dataRate.empty () ? "padrao" : dataRate) << " p2pRate=" << p2pRate;
+		return oss.str ();
+	}
+};
+
+// Produto cartesiano, nWifi varia mais devagar para as tabelas saírem na
+// mesma ordem do laço z antigo.
+inline bool
+MontarGrade (const EspecVarredura &e, std::vector<PontoGrade> &grade, std::string &erro)
+{
+	std::vector<uint32_t> nWifi, packetSize;
+	std::vector<std::string> dataRate, p2pRate;
+	if (!ExpandirEspecInteiro (e.nWifi, nWifi, erro)
+			|| !ExpandirEspecInteiro (e.packetSize, packetSize, erro)
+			|| !ExpandirEspec (e.dataRate, dataRate, erro)
+			|| !ExpandirEspec (e.p2pRate, p2pRate, erro)) {
+		return false;
+	}
+	bool multi = packetSize.size () > 1 || dataRate.size () > 1 || p2pRate.size () > 1;
+	grade.clear ();
+	for (uint32_t a = 0; a < nWifi.size (); a++) {
+		for (uint32_t b = 0; b < packetSize.size (); b++) {
+			for (uint32_t c = 0; c < dataRate.size (); c++) {
+				for (uint32_t d = 0; d < p2pRate.size (); d++) {
+					PontoGrade g;
+					g.nWifi = nWifi[a];
+					g.packetSize = packetSize[b];
+					g.dataRate = dataRate[c];
+					g.p2pRate = p2pRate[d];
+					if (multi) {
+						g.sufixo = "-s" + FormatarValor (g.packetSize, "") + "-r" + g.dataRate + "-b" + g.p2pRate;
+					}
+					grade.push_back (g);
+				}
+			}
+		}
+	}
+	return true;
+}
+
+// Ordem de impressão: por nWifi, mantendo a ordem da grade entre pontos de
+// mesmo nWifi (pontos acrescentados pela varredura adaptativa vão para o
+// lugar certo da tabela).
+inline std::vector<uint32_t>
+OrdemPorNWifi (const std::vector<PontoGrade> &grade)
+{
+	std::vector<std::pair<uint32_t, uint32_t> > chaves;
+	for (uint32_t i = 0; i < grade.size (); i++) {
+		chaves.push_back (std::make_pair (grade[i].nWifi, i));
+	}
+	std::sort (chaves.begin (), chaves.end ());
+	std::vector<uint32_t> ordem;
+	for (uint32_t i = 0; i < chaves.size (); i++) {
+		ordem.push_back (chaves[i].second);
+	}
+	return ordem;
+}
+
+#endif /* SWEEP_H */
@@ -0,0 +1,649 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef SWEEP_RUNNER_H
+#define SWEEP_RUNNER_H
+
+// Executor da varredura: transforma a grade em trabalhos (ponto, k), tira
+// do journal (--resume) e do cache o que já existe e simula o resto.
+//
+// Com --jobs=1 as rodadas rodam neste processo, uma depois da outra. Com
+// mais, cada rodada é um processo novo do mesmo executável (o Simulator do
+// ns-3 é global, não dá para ter duas simulações no mesmo processo) com os
+// argumentos originais mais --nWifi/--packetSize/... do ponto e
+// --workerK/--workerOut; o worker grava o ResultadoRodada no arquivo e o
+// processo pai cuida de cache e journal à medida que os workers terminam.
+//
+// Com --zygote o worker não passa por exec: o processo pai, que já carregou
+// as bibliotecas do ns-3, registrou os TypeId, leu a linha de comando e
+// percorreu os atributos (chave do cache), só faz fork e o filho chama
+// simular direto, copy-on-write. Funciona porque o pai nunca simula quando
+// jobs > 1: o Simulator do filho começa vazio. O custo de partida de cada
+// modo é medido pelo zygoteBench.cc.
+//
+// Os workers devolvem o resultado pela ResultArena (resultArena.h), um slot
+// por trabalho em memória compartilhada; o pai consome cada slot assim que
+// ele fica pronto, sem esperar o processo sair, e grava cache e journal
+// enquanto os outros simulam. Rodada que não cabe no slot, ou --shm=0, usa
+// o arquivo temporário como antes.
+//
+// Com --memBudget (MiB) o número de workers simultâneos também é limitado
+// pela memória: o pico de RSS de cada worker alimenta um
+// ModeloMemoria por nWifi (memoryModel.h), e só entra quem cabe no que
+// sobra do orçamento, o maior que couber primeiro, de modo que as rodadas
+// pequenas preenchem o espaço ao lado das grandes. Antes da primeira medida
+// roda uma rodada só, a de menor nWifi. O pico é o VmHWM que o próprio
+// worker lê no fim da rodada e grava no slot da arena: o ru_maxrss do wait4
+// traz o pico do pai, herdado no fork e mantido no exec. O filho do zygote
+// começa com as páginas do pai mapeadas no VmHWM e desconta o VmRSS que tinha
+// ao nascer; páginas do pai copiadas na escrita não entram na medida.
+//
+// O andamento (rodadas ativas com tempo simulado, relógio e eventos/s,
+// concluídas, fila e ETA) vai para --progress e, com --progressPort, para
+// http://127.0.0.1:<porta>/ (progress.h).
+
+#include "ns3/core-module.h"
+#include "sweep.h"
+#include "runResult.h"
+#include "runCache.h"
+#include "runJournal.h"
+#include "resultArena.h"
+#include "memoryModel.h"
+#include "progress.h"
+#include <string>
+#include <vector>
+#include <map>
+#include <algorithm>
+#include <functional>
+#include <iostream>
+#include <sstream>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <cerrno>
+#include <unistd.h>
+#include <sys/types.h>
+#include <sys/wait.h>
+#include <sys/stat.h>
+
+namespace ns3 {
+
+struct OpcoesVarredura {
+	EspecVarredura espec;
+	uint32_t jobs;
+	bool cache;
+	std::string cacheDir;
+	std::string journal;
+	bool resume;
+	bool journalOverwrite;
+	uint32_t adaptBudget;
+	std::string adaptMetric;
+	bool zygote;
+	bool shm;
+	uint32_t memBudget;
+	std::string progress;
+	uint32_t progressPort;
+
+	// só nos workers
+	uint32_t workerK;
+	std::string workerOut;
+	std::string workerSufixo;
+	int workerArena;
+	uint32_t workerSlot;
+
+	OpcoesVarredura (std::string cenario, std::string nWifi, std::string packetSize, std::string dataRate, std::string p2pRate)
+		: jobs (1),
+		  cache (false),
+		  cacheDir ("sim/cache"),
+		  journal ("sim/" + cenario + "/sweep.journal"),
+		  resume (false),
+		  journalOverwrite (false),
+		  adaptBudget (0),
+		  adaptMetric ("vazao"),
+		  zygote (false),
+		  shm (true),
+		  memBudget (0),
+		  progress ("sim/" + cenario + "/sweep.status"),
+		  progressPort (0),
+		  workerK (0),
+		  workerArena (-1),
+		  workerSlot (0)
+	{
+		espec.nWifi = nWifi;
+		espec.packetSize = packetSize;
+		espec.dataRate = dataRate;
+		espec.p2pRate = p2pRate;
+	}
+
+	void Registrar (CommandLine &cmd)
+	{
+		cmd.AddValue ("nWifi", "Wifi STA counts: list, ini:fim:passo or log:ini:fim:n", espec.nWifi);
+		cmd.AddValue ("packetSize", "Application packet sizes (same syntax as nWifi)", espec.packetSize);
+		cmd.AddValue ("dataRate", "Per-station data rates, e.g. 1Mbps,2Mbps or 0.5:2:0.5Mbps", espec.dataRate);
+		cmd.AddValue ("p2pRate", "Bandwidth of the AP-server point-to-point link (same syntax)", espec.p2pRate);
+		cmd.AddValue ("jobs", "Runs executed at the same time, each in its own process", jobs);
+		cmd.AddValue ("cache", "Reuse run results already stored in cacheDir", cache);
+		cmd.AddValue ("cacheDir", "Directory of the run result cache", cacheDir);
+		cmd.AddValue ("journal", "Append each finished run to this file (empty = off)", journal);
+		cmd.AddValue ("resume", "Skip the runs already in the journal and rebuild the tables from it", resume);
+		cmd.AddValue ("journalOverwrite", "Start a new journal even if the file already has runs (without resume)", journalOverwrite);
+		cmd.AddValue ("adaptBudget", "Total runs for adaptive nWifi refinement around the knee (0 = plain grid)", adaptBudget);
+		cmd.AddValue ("adaptMetric", "Metric followed by the refinement: vazao, perda or atraso", adaptMetric);
+		cmd.AddValue ("zygote", "With jobs > 1, fork workers from this initialized process instead of exec'ing a new one", zygote);
+		cmd.AddValue ("memBudget", "Memory budget for concurrent worker processes, in MiB (0 = only jobs limits)", memBudget);
+		cmd.AddValue ("progress", "Status file with per-run progress, counts and ETA (empty = off)", progress);
+		cmd.AddValue ("progressPort", "Also serve the status on http://127.0.0.1:<port>/ (0 = off)", progressPort);
+		cmd.AddValue ("shm", "Workers hand results back through a shared-memory arena instead of files", shm);
+		cmd.AddValue ("workerK", "Internal: repetition run by a worker process", workerK);
+		cmd.AddValue ("workerOut", "Internal: result file written by a worker process", workerOut);
+		cmd.AddValue ("workerSufixo", "Internal: file name suffix of the worker's grid point", workerSufixo);
+		cmd.AddValue ("workerArena", "Internal: descriptor of the shared result arena", workerArena);
+		cmd.AddValue ("workerSlot", "Internal: slot of the worker in the result arena", workerSlot);
+	}
+
+	bool Validar (std::string &erro) const
+	{
+		MetricaAlvo m;
+		if (!MetricaDeNome (adaptMetric, m)) {
+			erro = "metrica desconhecida '" + adaptMetric + "'";
+			return false;
+		}
+		// Sem --resume o journal é recriado; com rodadas dentro, só se pedido
+		struct stat st;
+		if (!EhWorker () && !journal.empty () && !resume && !journalOverwrite
+		    && stat (journal.c_str (), &st) == 0 && st.st_size > 0) {
+			erro = "journal '" + journal + "' ja tem rodadas; use --resume para continuar ou --journalOverwrite para recomecar";
+			return false;
+		}
+		if (memBudget > 0 && !shm) {
+			erro = "memBudget precisa da arena (--shm=1): o pico de RSS volta por ela";
+			return false;
+		}
+		return true;
+	}
+
+	bool EhWorker (void) const
+	{
+		return !workerOut.empty ();
+	}
+};
+
+class SweepRunner
+{
+public:
+	typedef std::function<std::string (const PontoGrade &)> Descrever;
+	typedef std::function<ResultadoRodada (const PontoGrade &, uint32_t)> Simular;
+
+	// Processo worker: a grade tem um único ponto (veio por argumento).
+	static int ExecutarWorker (const OpcoesVarredura &o, std::vector<PontoGrade> grade, Simular simular)
+	{
+		if (grade.size () != 1 || o.workerK == 0) {
+			std::cerr << "worker: esperado um unico ponto e workerK\n";
+			return 2;
+		}
+		grade[0].sufixo = o.workerSufixo;
+		ResultArena arena;
+		bool temArena = o.workerArena >= 0 && arena.Abrir (o.workerArena);
+		AmostradorProgresso amostrador;
+		if (temArena) {
+			amostrador.Iniciar (arena.Progresso (o.workerSlot));
+		}
+		ResultadoRodada resultado = simular (grade[0], o.workerK);
+		if (temArena) {
+			arena.GravarPicoRss (o.workerSlot, KiBStatus ("VmHWM:"));
+		}
+		if (temArena && arena.Publicar (o.workerSlot, resultado)) {
+			return 0;
+		}
+		return GravarSaida (o.workerOut, resultado) ? 0 : 1;
+	}
+
+	SweepRunner (int argc, char *argv[], std::string cenario, const OpcoesVarredura &o)
+		: m_argv (argv, argv + argc),
+		  m_opcoes (o),
+		  m_cache (o.cacheDir, cenario),
+		  m_journal (o.journal, o.resume),
+		  m_progresso (cenario, o.progress, o.progressPort),
+		  m_cenario (cenario),
+		  m_repeticao (0),
+		  m_simuladas (0)
+	{
+	}
+
+	// Pode ser chamado de novo com mais pontos (varredura adaptativa): os
+	// pontos são acrescentados à grade e só os novos são executados.
+	bool Executar (const std::vector<PontoGrade> &grade, uint32_t repeticao, Descrever descrever, Simular simular)
+	{
+		uint32_t primeiro = m_grade.size ();
+		m_grade.insert (m_grade.end (), grade.begin (), grade.end ());
+		m_repeticao = repeticao;
+		m_resultados.resize (m_grade.size () * repeticao);
+
+		std::vector<uint32_t> pendentes;
+		uint32_t reaproveitadas = 0;
+		for (uint32_t i = primeiro; i < m_grade.size (); i++) {
+			std::string parametros = descrever (m_grade[i]);
+			for (uint32_t k = 1; k <= repeticao; k++) {
+				Trabalho t;
+				t.ponto = i;
+				t.k = k;
+				t.chave = m_cache.Chave (parametros, m_grade[i].nWifi, k);
+				m_trabalhos.push_back (t);
+
+				uint32_t id = m_trabalhos.size () - 1;
+				if (m_journal.Buscar (t.chave, m_resultados[id])) {
+					std::cerr << "journal;" << m_grade[i].nWifi << ";" << k << ";retomada\n";
+					reaproveitadas++;
+				} else if (m_opcoes.cache && m_cache.Buscar (t.chave, m_resultados[id])) {
+					std::cerr << "cache;" << m_grade[i].nWifi << ";" << k << ";hit\n";
+					m_journal.Registrar (t.chave, m_resultados[id]);
+					reaproveitadas++;
+				} else {
+					pendentes.push_back (id);
+				}
+			}
+		}
+		m_simuladas += pendentes.size ();
+		m_progresso.Adicionar (pendentes.size (), reaproveitadas);
+
+		if (m_opcoes.jobs <= 1) {
+			std::vector<RelatorioProgresso::Ativa> ativas (1);
+			std::vector<uint32_t> fila;
+			for (uint32_t i = pendentes.size (); i > 1; i--) {
+				fila.push_back (NWifi (pendentes[i - 1]));
+			}
+			for (uint32_t i = 0; i < pendentes.size (); i++) {
+				const Trabalho &t = m_trabalhos[pendentes[i]];
+				RelatorioProgresso::Ativa ativa = { (int) getpid (), m_grade[t.ponto].nWifi, t.k, RelogioProgresso (), { 0.0, 0.0, 0 } };
+				ativas[0] = ativa;
+				if (m_progresso.Ativo ()) {
+					m_progresso.Atualizar (ativas, fila, 1, true);
+					m_amostrador.Iniciar (&ativas[0].amostra, [this, &ativas, &fila] () {
+						if (m_progresso.Vencido ()) {
+							m_progresso.Atualizar (ativas, fila, 1);
+						}
+						m_progresso.Atender ();
+					});
+				}
+				m_resultados[pendentes[i]] = simular (m_grade[t.ponto], t.k);
+				m_progresso.Concluida (ativa.nWifi, RelogioProgresso () - ativa.inicio);
+				Concluir (pendentes[i]);
+				if (!fila.empty ()) {
+					fila.pop_back ();
+				}
+			}
+			m_progresso.Atualizar (std::vector<RelatorioProgresso::Ativa> (), fila, 1, true);
+			return true;
+		}
+		return ExecutarProcessos (pendentes, simular);
+	}
+
+	const ResultadoRodada &Resultado (uint32_t ponto, uint32_t k) const
+	{
+		return m_resultados[ponto * m_repeticao + k - 1];
+	}
+
+	const std::vector<PontoGrade> &GetGrade (void) const
+	{
+		return m_grade;
+	}
+
+	// Rodadas que precisaram ser simuladas (fora journal e cache)
+	uint32_t GetSimuladas (void) const
+	{
+		return m_simuladas;
+	}
+
+	uint32_t GetJobs (void) const
+	{
+		return m_opcoes.jobs;
+	}
+
+private:
+	struct Trabalho {
+		uint32_t ponto;
+		uint32_t k;
+		std::string chave;
+	};
+
+	static bool GravarSaida (const std::string &saida, const ResultadoRodada &resultado)
+	{
+		FILE *f = fopen (saida.c_str (), "wb");
+		bool ok = f != 0 && GravarResultado (f, "", resultado);
+		ok = f != 0 && fclose (f) == 0 && ok;
+		return ok;
+	}
+
+	// Rodada parcial vai para o journal (a varredura não a repete) mas não
+	// para o cache
+	void Concluir (uint32_t id)
+	{
+		if (m_resultados[id].flags & RODADA_PARCIAL) {
+			const Trabalho &t = m_trabalhos[id];
+			std::cerr << "watchdog;" << m_grade[t.ponto].nWifi << ";" << t.k << ";parcial\n";
+		} else if (m_opcoes.cache) {
+			m_cache.Guardar (m_trabalhos[id].chave, m_resultados[id]);
+		}
+		m_journal.Registrar (m_trabalhos[id].chave, m_resultados[id]);
+	}
+
+	// Filho do zygote: simula e sai sem passar pelos destrutores do pai
+	pid_t Bifurcar (uint32_t id, const std::string &saida, ResultArena &arena, uint32_t slot, Simular simular)
+	{
+		const Trabalho &t = m_trabalhos[id];
+		std::cout.flush ();
+		std::cerr.flush ();
+		pid_t pid = fork ();
+		if (pid == 0) {
+			uint64_t herdado = KiBStatus ("VmRSS:");
+			m_amostrador.Iniciar (arena.Progresso (slot));
+			ResultadoRodada resultado = simular (m_grade[t.ponto], t.k);
+			uint64_t pico = KiBStatus ("VmHWM:");
+			arena.GravarPicoRss (slot, pico > herdado ? pico - herdado : 0);
+			bool ok = arena.Publicar (slot, resultado) || GravarSaida (saida, resultado);
+			std::cout.flush ();
+			std::cerr.flush ();
+			_exit (ok ? 0 : 1);
+		}
+		return pid;
+	}
+
+	pid_t Lancar (uint32_t id, const std::string &saida, const ResultArena &arena, uint32_t slot)
+	{
+		const Trabalho &t = m_trabalhos[id];
+		const PontoGrade &g = m_grade[t.ponto];
+		std::vector<std::string> args (m_argv);
+		std::ostringstream oss;
+		oss << "--nWifi=" << g.nWifi;
+		args.push_back (oss.str ());
+		oss.str ("");
+		oss << "--packetSize=" << g.packetSize;
+		args.push_back (oss.str ());
+		if (!g.dataRate.empty ()) {
+			args.push_back ("--dataRate=" + g.dataRate);
+		}
+		args.push_back ("--p2pRate=" + g.p2pRate);
+		oss.str ("");
+		oss << "--workerK=" << t.k;
+		args.push_back (oss.str ());
+		args.push_back ("--workerOut=" + saida);
+		if (arena.GetFd () >= 0) {
+			oss.str ("");
+			oss << "--workerArena=" << arena.GetFd ();
+			args.push_back (oss.str ());
+			oss.str ("");
+			oss << "--workerSlot=" << slot;
+			args.push_back (oss.str ());
+		}
+		if (!g.sufixo.empty ()) {
+			args.push_back ("--workerSufixo=" + g.sufixo);
+		}
+		args.push_back ("--jobs=1");
+
+		std::cout.flush ();
+		std::cerr.flush ();
+		pid_t pid = fork ();
+		if (pid == 0) {
+			std::vector<char *> cargs;
+			for (uint32_t i = 0; i < args.size (); i++) {
+				cargs.push_back (const_cast<char *> (args[i].c_str ()));
+			}
+			cargs.push_back (0);
+			execv ("/proc/self/exe", &cargs[0]);
+			execvp (cargs[0], &cargs[0]);
+			_exit (127);
+		}
+		return pid;
+	}
+
+	bool ExecutarProcessos (const std::vector<uint32_t> &pendentes, Simular simular)
+	{
+		std::string modelo = "/tmp/" + m_cenario + "-XXXXXX";
+		std::vector<char> dir (modelo.begin (), modelo.end ());
+		dir.push_back ('\0');
+		if (mkdtemp (&dir[0]) == 0) {
+			perror ("mkdtemp");
+			return false;
+		}
+		std::string tmp (&dir[0]);
+
+		// Slot = posição em pendentes; capacidade para dados e ACK de cada estação
+		uint32_t capacidade = 0;
+		for (uint32_t i = 0; i < pendentes.size (); i++) {
+			capacidade = std::max (capacidade, 2 * m_grade[m_trabalhos[pendentes[i]].ponto].nWifi + 8);
+		}
+		ResultArena arena;
+		if (m_opcoes.shm && !arena.Criar (pendentes.size (), capacidade)) {
+			perror ("arena de resultados");
+		}
+		std::vector<bool> consumido (pendentes.size (), false);
+
+		bool ok = true;
+		std::vector<uint32_t> fila;   // slots ainda não lançados, na ordem original
+		for (uint32_t i = 0; i < pendentes.size (); i++) {
+			fila.push_back (i);
+		}
+		std::vector<double> previsto (pendentes.size (), 0.0);
+		std::vector<double> lancamento (pendentes.size (), 0.0);
+		std::map<pid_t, uint32_t>::const_iterator c;
+		double emUso = 0.0;
+		std::map<pid_t, uint32_t> ativos;
+		while (!fila.empty () || !ativos.empty ()) {
+			while (ativos.size () < m_opcoes.jobs && !fila.empty ()) {
+				int escolhido = Admitir (fila, pendentes, emUso, ativos.empty ());
+				if (escolhido < 0) {
+					break;
+				}
+				uint32_t slot = fila[escolhido];
+				fila.erase (fila.begin () + escolhido);
+				uint32_t id = pendentes[slot];
+				pid_t pid = m_opcoes.zygote ? Bifurcar (id, Saida (tmp, id), arena, slot, simular)
+				                            : Lancar (id, Saida (tmp, id), arena, slot);
+				if (pid < 0) {
+					perror ("fork");
+					ok = false;
+					continue;
+				}
+				ativos[pid] = slot;
+				lancamento[slot] = RelogioProgresso ();
+				if (m_memoria.Calibrado ()) {
+					previsto[slot] = m_memoria.Prever (m_grade[m_trabalhos[id].ponto].nWifi);
+				}
+				emUso += previsto[slot];
+			}
+			if (ativos.empty ()) {
+				break;
+			}
+
+			// Resultados já publicados, mesmo de workers que ainda não saíram
+			for (c = ativos.begin (); c != ativos.end (); ++c) {
+				Consumir (arena, c->second, pendentes[c->second], consumido);
+			}
+			if (m_progresso.Vencido ()) {
+				AtualizarProgresso (arena, ativos, lancamento, fila, pendentes);
+			}
+			m_progresso.Atender ();
+
+			int status;
+			bool sondar = arena.GetFd () >= 0 || m_progresso.Ativo ();
+			pid_t pid = waitpid (-1, &status, sondar ? WNOHANG : 0);
+			if (pid == 0) {
+				usleep (1000);
+				continue;
+			}
+			if (pid < 0) {
+				if (errno == EINTR) {
+					continue;
+				}
+				perror ("waitpid");
+				ok = false;
+				break;
+			}
+			std::map<pid_t, uint32_t>::iterator a = ativos.find (pid);
+			if (a == ativos.end ()) {
+				continue;
+			}
+			uint32_t slot = a->second;
+			uint32_t id = pendentes[slot];
+			ativos.erase (a);
+			emUso -= previsto[slot];
+			m_progresso.Concluida (NWifi (id), RelogioProgresso () - lancamento[slot]);
+			uint64_t pico = arena.LerPicoRss (slot);
+			if (m_opcoes.memBudget > 0 && WIFEXITED (status) && pico > 0) {
+				uint32_t nWifi = m_grade[m_trabalhos[id].ponto].nWifi;
+				m_memoria.Adicionar (nWifi, pico / 1024.0);
+				std::cerr << "memoria;" << nWifi << ";" << m_trabalhos[id].k << ";" << pico / 1024 << "MiB\n";
+			}
+
+			// Publicado na arena vale mesmo que o worker falhe depois
+			if (Consumir (arena, slot, id, consumido) || consumido[slot]) {
+				continue;
+			}
+			std::string saida = Saida (tmp, id);
+			std::string chave;
+			FILE *f = fopen (saida.c_str (), "rb");
+			bool lido = f != 0 && LerResultado (f, chave, m_resultados[id]);
+			if (f != 0) {
+				fclose (f);
+			}
+			remove (saida.c_str ());
+			const Trabalho &t = m_trabalhos[id];
+			if (WIFEXITED (status) && WEXITSTATUS (status) == 0 && lido) {
+				Concluir (id);
+			} else {
+				std::cerr << "worker;" << m_grade[t.ponto].nWifi << ";" << t.k << ";falhou\n";
+				m_resultados[id] = ResultadoRodada ();
+				ok = false;
+			}
+		}
+		rmdir (tmp.c_str ());
+		AtualizarProgresso (arena, ativos, lancamento, fila, pendentes);
+		return ok;
+	}
+
+	// Campo em KiB de /proc/self/status (VmHWM:, VmRSS:), 0 se não der para ler
+	static uint64_t KiBStatus (const char *campo)
+	{
+		FILE *f = fopen ("/proc/self/status", "r");
+		if (f == 0) {
+			return 0;
+		}
+		char linha[256];
+		unsigned long long kib = 0;
+		size_t n = strlen (campo);
+		while (fgets (linha, sizeof (linha), f) != 0) {
+			if (strncmp (linha, campo, n) == 0) {
+				sscanf (linha + n, "%llu", &kib);
+				break;
+			}
+		}
+		fclose (f);
+		return kib;
+	}
+
+	// Posição em fila do próximo slot a lançar, ou -1 para esperar alguém sair
+	int Admitir (const std::vector<uint32_t> &fila, const std::vector<uint32_t> &pendentes, double emUso, bool ocioso) const
+	{
+		if (m_opcoes.memBudget == 0) {
+			return 0;
+		}
+		int menor = 0;
+		for (uint32_t i = 1; i < fila.size (); i++) {
+			if (NWifi (pendentes[fila[i]]) < NWifi (pendentes[fila[menor]])) {
+				menor = i;
+			}
+		}
+		if (!m_memoria.Calibrado ()) {
+			return ocioso ? menor : -1;
+		}
+
+		double livre = m_opcoes.memBudget - emUso;
+		int escolhido = -1;
+		for (uint32_t i = 0; i < fila.size (); i++) {
+			uint32_t n = NWifi (pendentes[fila[i]]);
+			if (m_memoria.Prever (n) <= livre && (escolhido < 0 || n > NWifi (pendentes[fila[escolhido]]))) {
+				escolhido = i;
+			}
+		}
+		if (escolhido < 0 && ocioso) {
+			// Nem sozinha cabe: roda assim mesmo, uma de cada vez
+			const Trabalho &t = m_trabalhos[pendentes[fila[menor]]];
+			std::cerr << "memoria;" << m_grade[t.ponto].nWifi << ";" << t.k << ";acima do orcamento\n";
+			return menor;
+		}
+		return escolhido;
+	}
+
+	void AtualizarProgresso (const ResultArena &arena, const std::map<pid_t, uint32_t> &ativos, const std::vector<double> &lancamento,
+	                         const std::vector<uint32_t> &fila, const std::vector<uint32_t> &pendentes)
+	{
+		std::vector<RelatorioProgresso::Ativa> ativas;
+		for (std::map<pid_t, uint32_t>::const_iterator a = ativos.begin (); a != ativos.end (); ++a) {
+			const Trabalho &t = m_trabalhos[pendentes[a->second]];
+			RelatorioProgresso::Ativa ativa = { (int) a->first, m_grade[t.ponto].nWifi, t.k, lancamento[a->second], { 0.0, 0.0, 0 } };
+			if (arena.GetFd () >= 0) {
+				arena.LerProgresso (a->second, ativa.amostra);
+			}
+			ativas.push_back (ativa);
+		}
+		std::vector<uint32_t> nFila;
+		for (uint32_t i = 0; i < fila.size (); i++) {
+			nFila.push_back (NWifi (pendentes[fila[i]]));
+		}
+		m_progresso.Atualizar (ativas, nFila, m_opcoes.jobs, true);
+	}
+
+	uint32_t NWifi (uint32_t id) const
+	{
+		return m_grade[m_trabalhos[id].ponto].nWifi;
+	}
+
+	bool Consumir (const ResultArena &arena, uint32_t slot, uint32_t id, std::vector<bool> &consumido)
+	{
+		if (consumido[slot] || !arena.Pronto (slot)) {
+			return false;
+		}
+		arena.Ler (slot, m_resultados[id]);
+		consumido[slot] = true;
+		Concluir (id);
+		return true;
+	}
+
+	static std::string Saida (const std::string &tmp, uint32_t id)
+	{
+		std::ostringstream oss;
+		oss << tmp << "/" << id << ".run";
+		return oss.str ();
+	}
+
+	std::vector<std::string> m_argv;
+	OpcoesVarredura m_opcoes;
+	RunCache m_cache;
+	RunJournal m_journal;
+	RelatorioProgresso m_progresso;
+	AmostradorProgresso m_amostrador;
+	std::string m_cenario;
+	std::vector<PontoGrade> m_grade;
+	uint32_t m_repeticao;
+	uint32_t m_simuladas;
+	std::vector<Trabalho> m_trabalhos;
+	std::vector<ResultadoRodada> m_resultados;
+	ModeloMemoria m_memoria;
+};
+
+} // namespace ns3
+
+#endif /* SWEEP_RUNNER_H */
@@ -0,0 +1,97 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "ns3/core-module.h"
+#include "traceReplay.h"
+#include <fstream>
+#include <cstdio>
+
+// Converte um trace texto para o formato binário do traceReplay.h.
+//
+// Entrada: uma linha por pacote, "tempo(s) tamanho(bytes) fluxo", com o
+// tempo crescente (ex.: saída de tshark -T fields -e frame.time_relative
+// -e frame.len mais o número da estação). Linhas começando com # são ignoradas.
+// A saída é escrita em streaming, sem carregar o trace em memória.
+//
+// Obs:
+// executar comando : ./waf --run "traceConvert --in=trace.txt --out=trace.bin"
+
+
+using namespace ns3;
+using namespace std;
+
+NS_LOG_COMPONENT_DEFINE ("TraceConvertProgram");
+
+
+int main (int argc, char *argv[]) {
+	std::string entrada;
+	std::string saida;
+
+	CommandLine cmd;
+	cmd.AddValue ("in", "Text trace: time(s) size(bytes) flow per line", entrada);
+	cmd.AddValue ("out", "Binary trace to write", saida);
+	cmd.Parse (argc,argv);
+
+	std::ifstream in (entrada.c_str ());
+	FILE *out = fopen (saida.c_str (), "wb");
+	if (!in.is_open () || out == 0)
+	{
+		std::cout << "Usage: traceConvert --in=trace.txt --out=trace.bin" << std::endl;
+		return 1;
+	}
+
+	TraceReplayHeader h;
+	memcpy (h.magic, TRACE_REPLAY_MAGIC, 8);
+	h.quantidade = 0;
+	fwrite (&h, sizeof (h), 1, out);
+
+	std::string linha;
+	uint64_t anterior = 0;
+	while (std::getline (in, linha)) {
+		if (linha.empty () || linha[0] == '#') {
+			continue;
+		}
+		double tempo;
+		uint32_t tamanho;
+		uint32_t fluxo = 0;
+		if (sscanf (linha.c_str (), "%lf %u %u", &tempo, &tamanho, &fluxo) < 2) {
+			continue;
+		}
+
+		TraceReplayRecord r;
+		r.tempoNs = (uint64_t) (tempo * 1e9 + 0.5);
+		r.tamanho = tamanho;
+		r.fluxo = fluxo;
+		if (r.tempoNs < anterior) {
+			std::cout << "Trace fora de ordem na linha " << h.quantidade + 1 << std::endl;
+			fclose (out);
+			return 1;
+		}
+		anterior = r.tempoNs;
+
+		fwrite (&r, sizeof (r), 1, out);
+		h.quantidade++;
+	}
+
+	// A quantidade só é conhecida no fim
+	fseek (out, 0, SEEK_SET);
+	fwrite (&h, sizeof (h), 1, out);
+	fclose (out);
+
+	std::cout << saida << ";" << h.quantidade << " registros\n";
+
+	return 0;
+}
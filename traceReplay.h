@@ -0,0 +1,362 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef TRACE_REPLAY_H
+#define TRACE_REPLAY_H
+
+// Aplicação que reproduz tráfego capturado a partir de um trace binário.
+//
+// Formato do arquivo (little-endian):
+//   cabeçalho: char magic[8] = "MO655TR1", uint64_t quantidade
+//   registros: uint64_t tempo (ns, crescente), uint32_t tamanho, uint32_t fluxo
+//
+// O arquivo é mapeado com mmap uma vez por processo (TraceReplayArquivo) e
+// percorrido direto do mapeamento, sem cópia nem índice no heap: cada
+// aplicação guarda só a posição do próximo registro e tem um único evento
+// pendente. Estações diferentes podem usar o mesmo arquivo filtrando pelo
+// campo fluxo; cada uma avança o próprio cursor até o próximo registro do
+// seu fluxo, então cada volta custa uma passada pelo arquivo por estação.
+// Com muitas estações e arquivos grandes, um arquivo por fluxo evita isso.
+//
+// Os registros precisam estar em ordem de tempo; o mapeamento confere isso
+// uma vez e aborta se não estiverem.
+//
+// Com Loop, cada volta dura o intervalo entre o primeiro e o último
+// registro mais um intervalo médio entre registros, (último - primeiro) *
+// n / (n - 1): o primeiro registro da volta seguinte não sai no mesmo
+// instante que o último da anterior. Um trace com duração zero é recusado,
+// senão a volta não avançaria o tempo simulado.
+//
+// Para gerar o trace a partir de texto, ver traceConvert.cc.
+
+#include "ns3/core-module.h"
+#include "ns3/network-module.h"
+#include "ns3/internet-module.h"
+#include <string>
+#include <cstring>
+#include <map>
+#include <memory>
+#include <stdint.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+namespace ns3 {
+
+struct TraceReplayRecord {
+	uint64_t tempoNs;
+	uint32_t tamanho;
+	uint32_t fluxo;
+};
+
+struct TraceReplayHeader {
+	char magic[8];
+	uint64_t quantidade;
+};
+
+static const char TRACE_REPLAY_MAGIC[8] = { 'M', 'O', '6', '5', '5', 'T', 'R', '1' };
+static const uint32_t TRACE_REPLAY_TODOS = 0xffffffff;
+
+// Mapeamento de um trace, compartilhado pelas aplicações do processo que
+// usam o mesmo arquivo; desfeito quando a última delas é descartada.
+class TraceReplayArquivo
+{
+public:
+	static std::shared_ptr<TraceReplayArquivo> Abrir (const std::string &arquivo)
+	{
+		static std::map<std::string, std::weak_ptr<TraceReplayArquivo> > abertos;
+		std::shared_ptr<TraceReplayArquivo> a = abertos[arquivo].lock ();
+		if (!a) {
+			a.reset (new TraceReplayArquivo (arquivo));
+			abertos[arquivo] = a;
+		}
+		return a;
+	}
+
+	~TraceReplayArquivo ()
+	{
+		munmap (m_mapa, m_tamanhoMapa);
+	}
+
+	const TraceReplayRecord *GetRegistros (void) const
+	{
+		return m_registros;
+	}
+
+	uint64_t GetQuantidade (void) const
+	{
+		return m_quantidade;
+	}
+
+	// Do primeiro ao último registro do arquivo
+	uint64_t GetDuracaoNs (void) const
+	{
+		return m_quantidade == 0 ? 0 : m_registros[m_quantidade - 1].tempoNs - m_registros[0].tempoNs;
+	}
+
+	// Período do Loop: a duração mais um intervalo médio entre registros
+	uint64_t GetPeriodoNs (void) const
+	{
+		if (m_quantidade < 2) {
+			return 0;
+		}
+		return GetDuracaoNs () + GetDuracaoNs () / (m_quantidade - 1);
+	}
+
+private:
+	TraceReplayArquivo (const std::string &arquivo)
+	{
+		int fd = open (arquivo.c_str (), O_RDONLY);
+		NS_ABORT_MSG_IF (fd < 0, "Nao foi possivel abrir o trace " << arquivo);
+
+		struct stat st;
+		fstat (fd, &st);
+		NS_ABORT_MSG_IF ((size_t) st.st_size < sizeof (TraceReplayHeader), "Trace truncado: " << arquivo);
+
+		m_tamanhoMapa = st.st_size;
+		m_mapa = mmap (0, m_tamanhoMapa, PROT_READ, MAP_SHARED, fd, 0);
+		close (fd);
+		NS_ABORT_MSG_IF (m_mapa == MAP_FAILED, "mmap falhou para " << arquivo);
+		madvise (m_mapa, m_tamanhoMapa, MADV_SEQUENTIAL);
+
+		const TraceReplayHeader *h = (const TraceReplayHeader *) m_mapa;
+		NS_ABORT_MSG_IF (memcmp (h->magic, TRACE_REPLAY_MAGIC, 8) != 0, "Trace com formato invalido: " << arquivo);
+
+		uint64_t cabem = (m_tamanhoMapa - sizeof (TraceReplayHeader)) / sizeof (TraceReplayRecord);
+		m_quantidade = h->quantidade < cabem ? h->quantidade : cabem;
+		m_registros = (const TraceReplayRecord *) ((const char *) m_mapa + sizeof (TraceReplayHeader));
+		for (uint64_t i = 1; i < m_quantidade; i++) {
+			NS_ABORT_MSG_IF (m_registros[i].tempoNs < m_registros[i - 1].tempoNs,
+					"Trace fora de ordem no registro " << i << ": " << arquivo);
+		}
+	}
+
+	TraceReplayArquivo (const TraceReplayArquivo &);
+	TraceReplayArquivo &operator= (const TraceReplayArquivo &);
+
+	void *m_mapa;
+	size_t m_tamanhoMapa;
+	const TraceReplayRecord *m_registros;
+	uint64_t m_quantidade;
+};
+
+class TraceReplayApplication : public Application
+{
+public:
+	static TypeId GetTypeId (void)
+	{
+		static TypeId tid = TypeId ("ns3::TraceReplayApplication")
+			.SetParent<Application> ()
+			.AddConstructor<TraceReplayApplication> ()
+			.AddAttribute ("TraceFile", "Binary trace (see traceReplay.h) to replay.",
+					StringValue (""),
+					MakeStringAccessor (&TraceReplayApplication::m_arquivo),
+					MakeStringChecker ())
+			.AddAttribute ("Flow", "Only replay records with this flow id (4294967295 = all).",
+					UintegerValue (TRACE_REPLAY_TODOS),
+					MakeUintegerAccessor (&TraceReplayApplication::m_fluxo),
+					MakeUintegerChecker<uint32_t> ())
+			.AddAttribute ("Remote", "The address of the destination.",
+					AddressValue (),
+					MakeAddressAccessor (&TraceReplayApplication::m_peer),
+					MakeAddressChecker ())
+			.AddAttribute ("Protocol", "The type of protocol to use.",
+					TypeIdValue (UdpSocketFactory::GetTypeId ()),
+					MakeTypeIdAccessor (&TraceReplayApplication::m_tid),
+					MakeTypeIdChecker ())
+			.AddAttribute ("MaxPacketSize", "Records larger than this are clamped.",
+					UintegerValue (65507),
+					MakeUintegerAccessor (&TraceReplayApplication::m_maxTamanho),
+					MakeUintegerChecker<uint32_t> (1))
+			.AddAttribute ("Loop", "Restart from the first record at the end of the trace.",
+					BooleanValue (false),
+					MakeBooleanAccessor (&TraceReplayApplication::m_loop),
+					MakeBooleanChecker ());
+		return tid;
+	}
+
+	TraceReplayApplication ()
+		: m_fluxo (TRACE_REPLAY_TODOS),
+		  m_maxTamanho (65507),
+		  m_loop (false),
+		  m_registros (0),
+		  m_quantidade (0),
+		  m_proximo (0),
+		  m_enviadosVolta (0),
+		  m_enviados (0)
+	{
+	}
+
+	virtual ~TraceReplayApplication ()
+	{
+	}
+
+	uint64_t GetSent (void) const
+	{
+		return m_enviados;
+	}
+
+protected:
+	virtual void DoDispose (void)
+	{
+		Desmapear ();
+		m_socket = 0;
+		Application::DoDispose ();
+	}
+
+private:
+	virtual void StartApplication (void)
+	{
+		Mapear ();
+		if (m_quantidade == 0) {
+			return;
+		}
+		NS_ABORT_MSG_IF (m_loop && m_trace->GetDuracaoNs () == 0,
+				"Loop com trace de duracao zero (todos os registros no mesmo instante): " << m_arquivo);
+
+		if (m_socket == 0) {
+			m_socket = Socket::CreateSocket (GetNode (), m_tid);
+			m_socket->Bind ();
+			m_socket->Connect (m_peer);
+			m_socket->SetRecvCallback (MakeNullCallback<void, Ptr<Socket> > ());
+		}
+
+		m_inicio = Simulator::Now ();
+		m_proximo = 0;
+		m_enviadosVolta = 0;
+		Agendar ();
+	}
+
+	virtual void StopApplication (void)
+	{
+		Simulator::Cancel (m_evento);
+		if (m_socket != 0) {
+			m_socket->Close ();
+		}
+	}
+
+	void Mapear (void)
+	{
+		if (m_trace || m_arquivo.empty ()) {
+			return;
+		}
+		m_trace = TraceReplayArquivo::Abrir (m_arquivo);
+		m_registros = m_trace->GetRegistros ();
+		m_quantidade = m_trace->GetQuantidade ();
+	}
+
+	void Desmapear (void)
+	{
+		m_trace.reset ();
+		m_registros = 0;
+		m_quantidade = 0;
+	}
+
+	// Leva m_proximo ao próximo registro do fluxo; false no fim do arquivo
+	bool Avancar (void)
+	{
+		if (m_fluxo != TRACE_REPLAY_TODOS) {
+			while (m_proximo < m_quantidade && m_registros[m_proximo].fluxo != m_fluxo) {
+				m_proximo++;
+			}
+		}
+		return m_proximo < m_quantidade;
+	}
+
+	void Agendar (void)
+	{
+		if (!Avancar ()) {
+			// Volta sem nenhum registro do fluxo: não há o que repetir
+			if (!m_loop || m_enviadosVolta == 0) {
+				return;
+			}
+			// A volta seguinte começa um período depois (> 0, ver StartApplication)
+			m_inicio += NanoSeconds (m_trace->GetPeriodoNs ());
+			m_proximo = 0;
+			m_enviadosVolta = 0;
+			Avancar ();
+		}
+		Time quando = m_inicio + NanoSeconds (m_registros[m_proximo].tempoNs - m_registros[0].tempoNs);
+		m_evento = Simulator::Schedule (quando - Simulator::Now (), &TraceReplayApplication::Enviar, this);
+	}
+
+	void Enviar (void)
+	{
+		uint32_t tamanho = m_registros[m_proximo].tamanho;
+		if (tamanho > m_maxTamanho) {
+			tamanho = m_maxTamanho;
+		}
+		m_socket->Send (Create<Packet> (tamanho));
+		m_enviados++;
+		m_enviadosVolta++;
+
+		m_proximo++;
+		Agendar ();
+	}
+
+	std::string m_arquivo;
+	uint32_t m_fluxo;
+	Address m_peer;
+	TypeId m_tid;
+	uint32_t m_maxTamanho;
+	bool m_loop;
+
+	std::shared_ptr<TraceReplayArquivo> m_trace;
+	const TraceReplayRecord *m_registros;
+	uint64_t m_quantidade;      // registros do arquivo
+	uint64_t m_proximo;         // cursor no arquivo
+	uint64_t m_enviadosVolta;
+
+	Ptr<Socket> m_socket;
+	Time m_inicio;
+	EventId m_evento;
+	uint64_t m_enviados;
+};
+
+NS_OBJECT_ENSURE_REGISTERED (TraceReplayApplication);
+
+
+class TraceReplayHelper
+{
+public:
+	TraceReplayHelper (std::string protocolo, Address remoto, std::string arquivo)
+	{
+		m_factory.SetTypeId ("ns3::TraceReplayApplication");
+		m_factory.Set ("Protocol", StringValue (protocolo));
+		m_factory.Set ("Remote", AddressValue (remoto));
+		m_factory.Set ("TraceFile", StringValue (arquivo));
+	}
+
+	void SetAttribute (std::string name, const AttributeValue &value)
+	{
+		m_factory.Set (name, value);
+	}
+
+	ApplicationContainer Install (Ptr<Node> node) const
+	{
+		Ptr<Application> app = m_factory.Create<Application> ();
+		node->AddApplication (app);
+		return ApplicationContainer (app);
+	}
+
+private:
+	ObjectFactory m_factory;
+};
+
+} // namespace ns3
+
+#endif /* TRACE_REPLAY_H */
@@ -0,0 +1,85 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef TRAFFIC_POLICIES_H
+#define TRAFFIC_POLICIES_H
+
+// Políticas de tráfego do Cenario (scenario.h).
+//
+// TrafegoRajada: OnOff TCP, um PacketSink por estação no servidor.
+// TrafegoCbr fica em cbrPolicy.h, junto com o CbrSource e o TraceReplay de
+// que só ele precisa: incluídos aqui, os TypeId deles seriam registrados
+// nos programas de rajada e os atributos entrariam na chave do cache.
+
+#include "scenario.h"
+
+namespace ns3 {
+
+struct TrafegoRajada {
+	struct Opcoes {
+	};
+
+	/*Padrão: 5 a 40 estações de 5 em 5, como o antigo laço z (start = 5)*/
+	static OpcoesVarredura Varredura (const std::string &nome)
+	{
+		return OpcoesVarredura (nome, "5:40:5", "1426", "1Mbps", "5Mbps");
+	}
+
+	static void Registrar (CommandLine &cmd, Opcoes &o, OpcoesVarredura &varredura)
+	{
+	}
+
+	static void Descrever (std::ostream &os, const Opcoes &o)
+	{
+	}
+
+	static void Configurar (void)
+	{
+		Config::SetDefault("ns3::TcpSocket::SegmentSize", UintegerValue(1440));
+	}
+
+	static void AtivarLog (void)
+	{
+		LogComponentEnable ("OnOffApplication", LOG_LEVEL_INFO);
+		LogComponentEnable ("PacketSink", LOG_LEVEL_INFO);
+	}
+
+	static void Instalar (const ParametrosCenario &p, const Opcoes &o, Ptr<Node> servidor, Ipv4Address endereco,
+			const NodeContainer &estacoes, ApplicationContainer &serverApps, ApplicationContainer &clientApps)
+	{
+		OnOffHelper onOffHelper ("ns3::TcpSocketFactory", endereco);
+		onOffHelper.SetAttribute ("OnTime", StringValue
+				("ns3::NormalRandomVariable[Mean=60.0|Variance=1.0|Bound=1.0]"));
+		onOffHelper.SetAttribute ("OffTime", StringValue
+				("ns3::NormalRandomVariable[Mean=1.0|Variance=1.0|Bound=1.0]"));
+		onOffHelper.SetAttribute ("DataRate",StringValue (p.dataRate));
+		onOffHelper.SetAttribute ("PacketSize", UintegerValue (p.packetSize));
+
+		/*Uma porta por estação: cada fluxo TCP tem o seu PacketSink*/
+		for (uint32_t i = 0; i < estacoes.GetN (); i++) {
+			AddressValue sinkAddress (InetSocketAddress (endereco, 201+i));
+			PacketSinkHelper  echoServer ("ns3::TcpSocketFactory", InetSocketAddress (endereco, 201+i));
+			serverApps.Add(echoServer.Install (servidor));
+
+			onOffHelper.SetAttribute("Remote", sinkAddress);
+			clientApps.Add(onOffHelper.Install (estacoes.Get (i)));
+		}
+	}
+};
+
+} // namespace ns3
+
+#endif /* TRAFFIC_POLICIES_H */
@@ -0,0 +1,231 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef WATCHDOG_H
+#define WATCHDOG_H
+
+// Limites por rodada de tempo de relógio e de eventos executados.
+//
+// O watchdog não depende do tempo simulado: um setitimer (ITIMER_REAL)
+// dispara SIGALRM a cada intervalo de relógio e o tratador compara o tempo
+// desde o Start e os eventos executados desde o Start com os limites. Um
+// livelock num único instante (eventos agendados com atraso zero, sem o
+// relógio simulado andar) é parado do mesmo jeito.
+//
+// Passado um limite, o tratador chama Stop no SimulatorImpl, que só liga o
+// m_stop conferido pelo Run entre um evento e outro. A rodada termina
+// normalmente: o FlowMonitor tem as estatísticas até ali e o programa marca
+// o resultado com RODADA_PARCIAL. O sweepRunner não guarda rodada parcial no
+// cache (depende da máquina) e a varredura segue para a próxima.
+//
+// Se um único evento não termina, o Run nunca volta para conferir o m_stop.
+// Depois da carência (10 intervalos, no mínimo 1 s) o tratador escreve
+// "watchdog;travado" e sai com _exit (3): o sweepRunner vê o worker falhar e
+// segue. Sem --jobs, a rodada roda no próprio processo da varredura e a
+// saída encerra a varredura inteira.
+//
+// O tratador só usa o que é seguro em sinal (clock_gettime, write, _exit)
+// e o SimulatorImpl guardado no Start; a mensagem do disparo normal sai no
+// Parar, já fora do Run.
+//
+// Os limites não entram na chave do cache: só mudam o resultado quando
+// disparam, e aí ele não vai para o cache.
+
+#include "ns3/core-module.h"
+#include <iostream>
+#include <string>
+#include <csignal>
+#include <ctime>
+#include <sys/time.h>
+#include <unistd.h>
+
+namespace ns3 {
+
+struct OpcoesWatchdog {
+	double tempoMax;      // s de relógio, 0 = sem limite
+	uint64_t eventosMax;  // 0 = sem limite
+	double intervalo;     // entre verificações, s de relógio
+
+	OpcoesWatchdog ()
+		: tempoMax (0.0),
+		  eventosMax (0),
+		  intervalo (0.1)
+	{
+	}
+
+	void Registrar (CommandLine &cmd)
+	{
+		cmd.AddValue ("limiteTempo", "Wall-clock budget of each run, in seconds (0 = none)", tempoMax);
+		cmd.AddValue ("limiteEventos", "Executed-event budget of each run (0 = none)", eventosMax);
+		cmd.AddValue ("limiteIntervalo", "Wall-clock time between watchdog checks, in seconds", intervalo);
+	}
+
+	bool Validar (std::string &erro) const
+	{
+		if (tempoMax < 0.0) {
+			erro = "limiteTempo negativo";
+			return false;
+		}
+		if (!(intervalo > 0.0)) {
+			erro = "limiteIntervalo deve ser positivo";
+			return false;
+		}
+		return true;
+	}
+
+	bool Ativo (void) const
+	{
+		return tempoMax > 0.0 || eventosMax > 0;
+	}
+};
+
+class Watchdog
+{
+public:
+	Watchdog (const OpcoesWatchdog &o)
+		: m_opcoes (o),
+		  m_impl (0),
+		  m_inicio (0.0),
+		  m_eventos0 (0),
+		  m_armado (false),
+		  m_motivo (0),
+		  m_decorrido (0.0),
+		  m_eventos (0)
+	{
+	}
+
+	~Watchdog ()
+	{
+		Parar ();
+	}
+
+	// Antes do Simulator::Run
+	void Start (void)
+	{
+		NS_ABORT_MSG_IF (Armado () != 0, "Ja existe um watchdog armado");
+		m_impl = PeekPointer (Simulator::GetImplementation ());
+		m_inicio = Relogio ();
+		m_eventos0 = m_impl->GetEventCount ();
+		m_motivo = 0;
+		Armado () = this;
+
+		struct sigaction acao;
+		acao.sa_handler = &Watchdog::Tratar;
+		sigemptyset (&acao.sa_mask);
+		acao.sa_flags = SA_RESTART;
+		sigaction (SIGALRM, &acao, &m_acaoAnterior);
+
+		struct itimerval periodo;
+		periodo.it_interval.tv_sec = (time_t) m_opcoes.intervalo;
+		periodo.it_interval.tv_usec = (suseconds_t) ((m_opcoes.intervalo - periodo.it_interval.tv_sec) * 1e6);
+		if (periodo.it_interval.tv_sec == 0 && periodo.it_interval.tv_usec == 0) {
+			periodo.it_interval.tv_usec = 1;
+		}
+		periodo.it_value = periodo.it_interval;
+		setitimer (ITIMER_REAL, &periodo, 0);
+		m_armado = true;
+	}
+
+	// Depois do Simulator::Run: desarma o timer e relata o disparo
+	void Parar (void)
+	{
+		if (!m_armado) {
+			return;
+		}
+		struct itimerval zero = {{0, 0}, {0, 0}};
+		setitimer (ITIMER_REAL, &zero, 0);
+		sigaction (SIGALRM, &m_acaoAnterior, 0);
+		Armado () = 0;
+		m_armado = false;
+		if (m_motivo != 0) {
+			std::cerr << "watchdog;" << (m_motivo == MOTIVO_TEMPO ? "tempo;" : "eventos;") << Simulator::Now ().GetSeconds ()
+				<< ";" << m_decorrido << ";" << m_eventos << "\n";
+		}
+	}
+
+	bool Disparou (void) const
+	{
+		return m_motivo != 0;
+	}
+
+private:
+	enum {
+		MOTIVO_TEMPO = 1,
+		MOTIVO_EVENTOS = 2
+	};
+
+	static double Relogio (void)
+	{
+		struct timespec t;
+		clock_gettime (CLOCK_MONOTONIC, &t);
+		return t.tv_sec + t.tv_nsec * 1e-9;
+	}
+
+	static void Tratar (int)
+	{
+		Watchdog *w = Armado ();
+		if (w != 0) {
+			w->Verificar ();
+		}
+	}
+
+	void Verificar (void)
+	{
+		double decorrido = Relogio () - m_inicio;
+		if (m_motivo != 0) {
+			double carencia = 10 * m_opcoes.intervalo < 1.0 ? 1.0 : 10 * m_opcoes.intervalo;
+			if (decorrido - m_decorrido > carencia) {
+				static const char msg[] = "watchdog;travado\n";
+				ssize_t escrito = write (STDERR_FILENO, msg, sizeof (msg) - 1);
+				(void) escrito;
+				_exit (3);
+			}
+			return;
+		}
+		uint64_t eventos = m_impl->GetEventCount () - m_eventos0;
+		if (m_opcoes.tempoMax > 0.0 && decorrido > m_opcoes.tempoMax) {
+			m_motivo = MOTIVO_TEMPO;
+		} else if (m_opcoes.eventosMax > 0 && eventos > m_opcoes.eventosMax) {
+			m_motivo = MOTIVO_EVENTOS;
+		} else {
+			return;
+		}
+		m_decorrido = decorrido;
+		m_eventos = eventos;
+		m_impl->Stop ();
+	}
+
+	// O tratador de sinal não recebe contexto: um watchdog armado por vez
+	static Watchdog *volatile &Armado (void)
+	{
+		static Watchdog *volatile armado = 0;
+		return armado;
+	}
+
+	OpcoesWatchdog m_opcoes;
+	SimulatorImpl *m_impl;
+	double m_inicio;
+	uint64_t m_eventos0;
+	bool m_armado;
+	volatile sig_atomic_t m_motivo;
+	double m_decorrido;
+	uint64_t m_eventos;
+	struct sigaction m_acaoAnterior;
+};
+
+} // namespace ns3
+
+#endif /* WATCHDOG_H */
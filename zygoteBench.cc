@@ -0,0 +1,152 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "ns3/core-module.h"
+#include "ns3/point-to-point-module.h"
+#include "ns3/network-module.h"
+#include "ns3/applications-module.h"
+#include "ns3/wifi-module.h"
+#include "ns3/mobility-module.h"
+#include "ns3/csma-module.h"
+#include "ns3/internet-module.h"
+#include "ns3/flow-monitor-module.h"
+#include "runCache.h"
+#include <vector>
+#include <algorithm>
+#include <unistd.h>
+#include <sys/time.h>
+#include <sys/wait.h>
+
+// Benchmark da partida dos workers do sweepRunner.h: exec a frio contra
+// fork do zygote.
+//
+// Mede, para cada amostra, do fork até o filho avisar por um pipe que está
+// pronto para simular. No modo exec o filho é este executável de novo: o
+// loader carrega as bibliotecas do ns-3, os construtores estáticos registram
+// os TypeId e a CommandLine é lida, como num worker do --jobs sem --zygote.
+// No modo zygote o pai fez tudo isso uma vez (inclusive o percurso dos
+// atributos da chave do cache) e o filho só herda a memória.
+//
+// Obs:
+// executar comando : ./waf --run "zygoteBench --amostras=50"
+
+
+using namespace ns3;
+using namespace std;
+
+NS_LOG_COMPONENT_DEFINE ("ZygoteBenchProgram");
+
+
+double agora (void) {
+	struct timeval tv;
+	gettimeofday (&tv, 0);
+	return tv.tv_sec + tv.tv_usec / 1e6;
+}
+
+// Tempo até o filho escrever no pipe; -1 se falhar
+double medir (bool exec) {
+	int fd[2];
+	if (pipe (fd) != 0) {
+		return -1;
+	}
+	std::cout.flush ();
+	double inicio = agora ();
+	pid_t pid = fork ();
+	if (pid == 0) {
+		close (fd[0]);
+		if (exec) {
+			std::string arg = "--pronto=" + std::to_string (fd[1]);
+			char *args[] = { const_cast<char *> ("zygoteBench"), const_cast<char *> (arg.c_str ()), 0 };
+			execv ("/proc/self/exe", args);
+			_exit (127);
+		}
+		char c = 1;
+		_exit (write (fd[1], &c, 1) == 1 ? 0 : 1);
+	}
+	close (fd[1]);
+	char c;
+	bool ok = pid > 0 && read (fd[0], &c, 1) == 1;
+	double duracao = agora () - inicio;
+	close (fd[0]);
+	int status;
+	if (pid > 0) {
+		waitpid (pid, &status, 0);
+	}
+	return ok ? duracao : -1;
+}
+
+void imprimir (std::string modo, std::vector<double> t) {
+	std::sort (t.begin (), t.end ());
+	double soma = 0.0;
+	for (uint32_t i = 0; i < t.size (); i++) {
+		soma += t[i];
+	}
+	std::cout << modo << ";";
+	std::cout << t.size () << ";";
+	std::cout << 1000 * soma / t.size () << ";";
+	std::cout << 1000 * t[t.size () / 2] << ";";
+	std::cout << 1000 * t.back () << ";";
+	std::cout << "\n";
+}
+
+
+int main (int argc, char *argv[]) {
+	uint32_t amostras = 20;
+	int pronto = -1;
+
+	CommandLine cmd;
+	cmd.AddValue ("amostras", "Workers started in each mode", amostras);
+	cmd.AddValue ("pronto", "Internal: pipe the exec'd child writes to when ready", pronto);
+	cmd.Parse (argc,argv);
+
+	if (pronto >= 0) {
+		char c = 1;
+		return write (pronto, &c, 1) == 1 ? 0 : 1;
+	}
+	if (amostras == 0) {
+		amostras = 1;
+	}
+
+	// O que o pai do sweepRunner faz antes de lançar workers
+	AtributosNs3 ();
+
+	std::vector<double> exec, zygote;
+	for (uint32_t i = 0; i < amostras; i++) {
+		double t = medir (true);
+		if (t >= 0) {
+			exec.push_back (t);
+		}
+		t = medir (false);
+		if (t >= 0) {
+			zygote.push_back (t);
+		}
+	}
+	if (exec.empty () || zygote.empty ()) {
+		std::cout << "Falha ao iniciar os workers" << std::endl;
+		return 1;
+	}
+
+	std::cout << "Modo;";
+	std::cout << "Amostras;";
+	std::cout << "Media(ms);";
+	std::cout << "Mediana(ms);";
+	std::cout << "Max(ms);";
+	std::cout << "\n";
+	imprimir ("exec", exec);
+	imprimir ("zygote", zygote);
+
+	return 0;
+}